@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "async_file_writer.h"
+
+#include <cassert>
+
+namespace aub_stream {
+
+AsyncFileWriter::AsyncFileWriter(size_t queueDepth, size_t chunkSize, WriteFunction writeFunction)
+    : chunks(queueDepth), writeFunction(std::move(writeFunction)) {
+    assert(queueDepth > 0);
+    for (auto &chunk : chunks) {
+        chunk.reserve(chunkSize);
+    }
+    writerThread = std::thread(&AsyncFileWriter::run, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    waitForIdle();
+
+    // ring is empty, bump tail only to wake the writer thread up
+    stopRequested.store(true, std::memory_order_release);
+    tail.fetch_add(1, std::memory_order_release);
+    tail.notify_one();
+    writerThread.join();
+}
+
+void AsyncFileWriter::push(std::vector<char> &chunk) {
+    if (chunk.empty()) {
+        return;
+    }
+    rethrowPendingError();
+
+    auto currentTail = tail.load(std::memory_order_relaxed);
+    auto currentHead = head.load(std::memory_order_acquire);
+    while (currentTail - currentHead == chunks.size()) {
+        head.wait(currentHead, std::memory_order_acquire);
+        currentHead = head.load(std::memory_order_acquire);
+    }
+
+    // slot contents were cleared by the consumer, swapping keeps both capacities alive
+    chunks[currentTail % chunks.size()].swap(chunk);
+    tail.store(currentTail + 1, std::memory_order_release);
+    tail.notify_one();
+}
+
+void AsyncFileWriter::drain() {
+    waitForIdle();
+    rethrowPendingError();
+}
+
+void AsyncFileWriter::waitForIdle() {
+    auto currentTail = tail.load(std::memory_order_relaxed);
+    auto currentHead = head.load(std::memory_order_acquire);
+    while (currentHead != currentTail) {
+        head.wait(currentHead, std::memory_order_acquire);
+        currentHead = head.load(std::memory_order_acquire);
+    }
+}
+
+void AsyncFileWriter::run() {
+    auto currentHead = head.load(std::memory_order_relaxed);
+    while (true) {
+        auto currentTail = tail.load(std::memory_order_acquire);
+        if (currentHead == currentTail) {
+            tail.wait(currentTail, std::memory_order_acquire);
+            continue;
+        }
+        if (stopRequested.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        auto &chunk = chunks[currentHead % chunks.size()];
+        if (!writeFailed.load(std::memory_order_relaxed)) {
+            try {
+                writeFunction(chunk.data(), chunk.size());
+            } catch (...) {
+                pendingError = std::current_exception();
+                writeFailed.store(true, std::memory_order_release);
+            }
+        }
+        chunk.clear();
+
+        head.store(++currentHead, std::memory_order_release);
+        head.notify_one();
+    }
+}
+
+void AsyncFileWriter::rethrowPendingError() {
+    // errors are sticky, remaining chunks are dropped once a write failed
+    if (writeFailed.load(std::memory_order_acquire) && !errorReported) {
+        errorReported = true;
+        std::rethrow_exception(pendingError);
+    }
+}
+
+} // namespace aub_stream
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace aub_stream {
+
+// Single-producer/single-consumer ring of pre-allocated chunks drained to disk by a dedicated thread.
+// The producer hands over a filled chunk with push() and gets an empty one back, so no allocation
+// happens in steady state. push() blocks while all chunks are in flight (backpressure).
+struct AsyncFileWriter {
+    using WriteFunction = std::function<void(const char *buffer, size_t size)>;
+
+    AsyncFileWriter(size_t queueDepth, size_t chunkSize, WriteFunction writeFunction);
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter &) = delete;
+    AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+    void push(std::vector<char> &chunk);
+    void drain();
+
+    size_t getQueueDepth() const { return chunks.size(); }
+
+  protected:
+    void run();
+    void waitForIdle();
+    void rethrowPendingError();
+
+    std::vector<std::vector<char>> chunks;
+    WriteFunction writeFunction;
+
+    alignas(64) std::atomic<uint64_t> head{0}; // next chunk to be written by the consumer
+    alignas(64) std::atomic<uint64_t> tail{0}; // next chunk to be filled by the producer
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> writeFailed{false};
+    std::exception_ptr pendingError; // set by the writer thread before writeFailed
+    bool errorReported = false;
+    std::thread writerThread;
+};
+
+} // namespace aub_stream
@@ -11,18 +11,35 @@
 #include "aubstream/hint_values.h"
 #include "aubstream/hardware_context.h"
 #include "gfx_core_family.h"
+#include "hash_helpers.h"
+#include "metrics_registry.h"
 #include "options.h"
+#include "pattern_helpers.h"
 
 #include <cassert>
 #include <string.h>
 #include <algorithm>
 #include <limits>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
 namespace aub_stream {
 
 AubFileStream::~AubFileStream() {
     if (fileHandle.isOpen()) {
+        flushWriteBuffer();
+        asyncWriter.reset();
+        if (compressedWriter) {
+            compressedWriter->finish();
+            compressedWriter.reset();
+        }
         fileHandle.close();
+        closeFileDescriptor();
     }
 }
 
@@ -61,7 +78,7 @@ void AubFileStream::addComment(const char *message) {
         remaining -= chunkBytes;
     } while (remaining > 0);
 
-    fileHandle.flush();
+    commitRecord();
 }
 
 void AubFileStream::declareContextForDumping(uint32_t handleDumpContext, PageTable *ppgtt) {
@@ -88,7 +105,7 @@ void AubFileStream::declareContextForDumping(uint32_t handleDumpContext, PageTab
     }
 
     write((char *)&cmd, sizeof(cmd));
-    fileHandle.flush();
+    commitRecord();
 }
 
 void AubFileStream::dumpBufferBIN(AubStream::PageTableType gttType, uint64_t gfxAddress, size_t size, uint32_t handleDumpContext) {
@@ -110,7 +127,7 @@ void AubFileStream::dumpBufferBIN(AubStream::PageTableType gttType, uint64_t gfx
     cmd.DirectoryHandle = handleDumpContext;
 
     write(reinterpret_cast<char *>(&cmd), sizeof(cmd));
-    fileHandle.flush();
+    commitRecord();
 }
 
 void AubFileStream::dumpSurface(PageTableType gttType, const SurfaceInfo &surfaceInfo, uint32_t handleDumpContext) {
@@ -156,7 +173,7 @@ void AubFileStream::dumpSurface(PageTableType gttType, const SurfaceInfo &surfac
     cmd.auxEncodingFormat = surfaceInfo.auxEncodingFormat;
 
     write(reinterpret_cast<char *>(&cmd), sizeof(cmd));
-    fileHandle.flush();
+    commitRecord();
 }
 
 bool AubFileStream::init(int stepping, const GpuDescriptor &gpu) {
@@ -189,7 +206,7 @@ bool AubFileStream::init(int stepping, const GpuDescriptor &gpu) {
         tmpWriteBuffer.clear();
     }
 
-    fileHandle.flush();
+    commitRecord();
     return true;
 }
 
@@ -245,20 +262,18 @@ void AubFileStream::expectMemoryTable(const void *memory, size_t size, const std
         cmd.dwordCount = static_cast<uint32_t>(dwordCount - 1);
         cmd.dataSizeInBytes = static_cast<uint32_t>(sizeThisIteration);
 
-        write((char *)&cmd, headerSize);
-        write((char *)memory, entry.size);
-
+        uint32_t zero = 0;
         auto remainder = entry.size & (sizeof(uint32_t) - 1);
-        if (remainder) {
-            uint32_t zero = 0;
-            write((const char *)&zero, sizeof(uint32_t) - remainder);
-        }
+        WriteChunk chunks[] = {{(const char *)&cmd, headerSize},
+                               {(const char *)memory, entry.size},
+                               {(const char *)&zero, remainder ? sizeof(uint32_t) - remainder : 0}};
+        writeGathered(chunks, remainder ? 3 : 2);
 
         memory = entry.size + (uint8_t *)memory;
         sizeWritten += entry.size;
     }
 
-    fileHandle.flush();
+    sync();
     assert(sizeWritten == size);
 }
 
@@ -273,17 +288,94 @@ void AubFileStream::reserveContiguousPages(const std::vector<uint64_t> &entries)
         cmd.address = page;
         write((char *)&cmd, sizeof(cmd));
     }
-    fileHandle.flush();
+    commitRecord();
 }
 
 void AubFileStream::writeContiguousPages(const void *memory, size_t size, uint64_t physAddress, int addressSpace, int hint) {
+    auto bytes = reinterpret_cast<const uint8_t *>(memory);
+    if (!memory || (!elideRepeatedPages && !pageContentCache)) {
+        writeMemoryRecords(bytes, size, physAddress, addressSpace, hint);
+        commitRecord();
+        return;
+    }
+
+    // pages are classified one by one, consecutive pages sharing an action are emitted as one run
+    auto runAction = PageAction::write;
+    uint32_t runValue = 0;
+    size_t runStart = 0;
+    auto emitRun = [&](size_t runEnd) {
+        if (runAction == PageAction::write) {
+            writeMemoryRecords(bytes + runStart, runEnd - runStart, physAddress + runStart, addressSpace, hint);
+        } else if (runAction == PageAction::repeat) {
+            writeRepeatedMemoryRecord(runValue, runEnd - runStart, physAddress + runStart, addressSpace, hint);
+        }
+        runStart = runEnd;
+    };
+
+    // leading and trailing partial pages are always written
+    auto offset = std::min(size, static_cast<size_t>(((physAddress + contentPageSize - 1) & ~uint64_t(contentPageSize - 1)) - physAddress));
+    if (pageContentCache) {
+        pageContentCache->invalidate(physAddress, offset, addressSpace);
+    }
+
+    while (offset + contentPageSize <= size) {
+        uint32_t value = 0;
+        auto action = classifyPages(bytes + offset, contentPageSize, physAddress + offset, addressSpace, value);
+        bool extendsRun = action == runAction &&
+                          (action != PageAction::repeat || (value == runValue && offset - runStart < maxRepeatedMemorySize));
+        if (!extendsRun) {
+            emitRun(offset);
+            runAction = action;
+            runValue = value;
+        }
+        offset += contentPageSize;
+    }
+
+    if (offset < size) {
+        if (pageContentCache) {
+            pageContentCache->invalidate(physAddress + offset, size - offset, addressSpace);
+        }
+        if (runAction != PageAction::write) {
+            emitRun(offset);
+            runAction = PageAction::write;
+        }
+    }
+    emitRun(size);
+    commitRecord();
+}
+
+AubFileStream::PageAction AubFileStream::classifyPages(const uint8_t *memory, size_t size, uint64_t physAddress, int addressSpace, uint32_t &repeatedValue) {
+    assert(size > 0 && (size % contentPageSize) == 0);
+    // a multi-page range is skipped or repeated only when every page agrees
+    bool allUnchanged = pageContentCache != nullptr;
+    bool allRepeated = elideRepeatedPages;
+    for (size_t offset = 0; offset < size; offset += contentPageSize) {
+        auto page = memory + offset;
+        if (pageContentCache && !pageContentCache->update(physAddress + offset, addressSpace, xxHash64(page, contentPageSize))) {
+            allUnchanged = false;
+        }
+        uint32_t value = 0;
+        if (allRepeated && (!isUniformDwordPattern(page, contentPageSize, value) || (offset && value != repeatedValue))) {
+            allRepeated = false;
+        }
+        repeatedValue = offset ? repeatedValue : value;
+    }
+
+    if (allUnchanged) {
+        pageContentCache->addBytesSaved(size);
+        return PageAction::skip;
+    }
+    return allRepeated ? PageAction::repeat : PageAction::write;
+}
+
+void AubFileStream::writeMemoryRecords(const uint8_t *memory, size_t size, uint64_t physAddress, int addressSpace, int hint) {
     auto sizeMemoryWriteHeader = sizeof(CmdServicesMemTraceMemoryWrite) - sizeof(CmdServicesMemTraceMemoryWrite::data);
     auto maxDwordCount = static_cast<uint32_t>(std::numeric_limits<uint16_t>::max());
     auto maxChunkSize = static_cast<size_t>((maxDwordCount - (sizeMemoryWriteHeader / sizeof(uint32_t))) * sizeof(uint32_t));
     assert(maxChunkSize > 0);
 
     auto remainingSize = size;
-    auto currentMemory = reinterpret_cast<const uint8_t *>(memory);
+    auto currentMemory = memory;
     auto currentPhysAddress = physAddress;
 
     while (remainingSize > 0) {
@@ -303,20 +395,37 @@ void AubFileStream::writeContiguousPages(const void *memory, size_t size, uint64
         header.addressSpace = addressSpace;
         header.dataSizeInBytes = static_cast<uint32_t>(chunkSize);
 
-        write(reinterpret_cast<const char *>(&header), sizeMemoryWriteHeader);
-        write(reinterpret_cast<const char *>(currentMemory), chunkSize);
-
+        uint32_t zero = 0;
         auto remainder = chunkSize & (sizeof(uint32_t) - 1);
-        if (remainder) {
-            uint32_t zero = 0;
-            write(reinterpret_cast<const char *>(&zero), sizeof(uint32_t) - remainder);
-        }
+        WriteChunk chunks[] = {{reinterpret_cast<const char *>(&header), sizeMemoryWriteHeader},
+                               {reinterpret_cast<const char *>(currentMemory), chunkSize},
+                               {reinterpret_cast<const char *>(&zero), remainder ? sizeof(uint32_t) - remainder : 0}};
+        writeGathered(chunks, remainder ? 3 : 2);
 
         currentMemory += chunkSize;
         currentPhysAddress += chunkSize;
         remainingSize -= chunkSize;
     }
-    fileHandle.flush();
+}
+
+void AubFileStream::writeRepeatedMemoryRecord(uint32_t value, size_t size, uint64_t physAddress, int addressSpace, int hint) {
+    assert(size <= maxRepeatedMemorySize);
+    auto sizeMemoryWriteHeader = sizeof(CmdServicesMemTraceMemoryWrite) - sizeof(CmdServicesMemTraceMemoryWrite::data);
+
+    // payload is a single dword the replayer repeats over dataSizeInBytes
+    CmdServicesMemTraceMemoryWrite header = {};
+    header.setHeader();
+    header.dwordCount = static_cast<uint32_t>(sizeMemoryWriteHeader / sizeof(uint32_t));
+    header.address = physAddress;
+    header.repeatMemory = CmdServicesMemTraceMemoryWrite::RepeatMemoryValues::Repeat;
+    header.tiling = CmdServicesMemTraceMemoryWrite::TilingValues::NoTiling;
+    header.dataTypeHint = hint;
+    header.addressSpace = addressSpace;
+    header.dataSizeInBytes = static_cast<uint32_t>(size);
+
+    WriteChunk chunks[] = {{reinterpret_cast<const char *>(&header), sizeMemoryWriteHeader},
+                           {reinterpret_cast<const char *>(&value), sizeof(value)}};
+    writeGathered(chunks, 2);
 }
 
 void AubFileStream::writeDiscontiguousPages(const void *memory, size_t size, const std::vector<PageInfo> &writeInfoTable, int hint) {
@@ -357,19 +466,21 @@ void AubFileStream::writeDiscontiguousPages(const void *memory, size_t size, con
             }
 
             cmd.numberOfAddressDataPairs = index;
-            write((char *)&cmd, headerSize);
+            gatherList.clear();
+            gatherList.push_back({(const char *)&cmd, headerSize});
 
             while (itorDumpStart != itorCurrent) {
                 bool unalignedSize = itorDumpStart->size & (sizeof(uint32_t) - 1);
                 bool unalignedAddress = itorDumpStart->physicalAddress & (sizeof(uint32_t) - 1);
                 bool differentAddressSpace = (isLocalMemory != itorDumpStart->isLocalMemory);
                 if (!unalignedSize && !unalignedAddress && !differentAddressSpace) {
-                    write((const char *)ptrDump, itorDumpStart->size);
+                    gatherList.push_back({(const char *)ptrDump, itorDumpStart->size});
                 }
 
                 ptrDump = itorDumpStart->size + (uint8_t *)ptrDump;
                 ++itorDumpStart;
             }
+            writeGathered(gatherList.data(), gatherList.size());
 
             cmd.dwordCount = 0;
             index = 0;
@@ -384,16 +495,34 @@ void AubFileStream::writeDiscontiguousPages(const void *memory, size_t size, con
             auto alignedBlockSize = (writeInfo.size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
             auto dwordCount = static_cast<uint32_t>(alignedBlockSize / sizeof(uint32_t));
             bool exceedsDiscontiguousPayloadLimit = dwordCount > maxDataDwordCount;
+            bool contiguousFallback = unalignedSize || unalignedAddress || differentAddressSpace || exceedsDiscontiguousPayloadLimit;
+
+            // whole pages staying in this command may instead be skipped as unchanged or written as a repeat record
+            uint32_t repeatedValue = 0;
+            auto pageAction = PageAction::write;
+            if (!contiguousFallback && memory && (elideRepeatedPages || pageContentCache)) {
+                bool wholePages = !(writeInfo.size % contentPageSize) && !(writeInfo.physicalAddress % contentPageSize);
+                if (wholePages) {
+                    pageAction = classifyPages(reinterpret_cast<const uint8_t *>(ptr), writeInfo.size, writeInfo.physicalAddress, addressSpace, repeatedValue);
+                } else if (pageContentCache) {
+                    pageContentCache->invalidate(writeInfo.physicalAddress, writeInfo.size, addressSpace);
+                }
+            }
 
-            if (unalignedSize || unalignedAddress || differentAddressSpace || exceedsDiscontiguousPayloadLimit) {
+            if (contiguousFallback || pageAction != PageAction::write) {
                 flushDiscontiguousToken();
 
-                writeContiguousPages(
-                    ptr,
-                    writeInfo.size,
-                    writeInfo.physicalAddress,
-                    writeInfo.isLocalMemory ? AddressSpaceValues::TraceLocal : AddressSpaceValues::TraceNonlocal,
-                    hint);
+                auto entryAddressSpace = writeInfo.isLocalMemory ? AddressSpaceValues::TraceLocal : AddressSpaceValues::TraceNonlocal;
+                if (pageAction == PageAction::repeat) {
+                    writeRepeatedMemoryRecord(repeatedValue, writeInfo.size, writeInfo.physicalAddress, entryAddressSpace, hint);
+                } else if (pageAction == PageAction::write) {
+                    writeContiguousPages(
+                        ptr,
+                        writeInfo.size,
+                        writeInfo.physicalAddress,
+                        entryAddressSpace,
+                        hint);
+                }
 
                 ptr = writeInfo.size + (uint8_t *)ptr;
                 ptrDump = ptr;
@@ -432,7 +561,7 @@ void AubFileStream::writeDiscontiguousPages(const void *memory, size_t size, con
         }
 
         flushDiscontiguousToken();
-        fileHandle.flush();
+        commitRecord();
         assert(writtenSize == size);
     }
 }
@@ -489,6 +618,9 @@ void AubFileStream::writeDiscontiguousPages(const std::vector<PageEntryInfo> &wr
             assert(index < maxEntries);
             cmd.Dword_2_To_190[index].dataSizeInBytes = sizeof(writeInfo.tableEntry);
             cmd.Dword_2_To_190[index].address = writeInfo.physicalAddress;
+            if (pageContentCache) {
+                pageContentCache->invalidate(writeInfo.physicalAddress, sizeof(writeInfo.tableEntry), addressSpace);
+            }
 
             cmd.dwordCount += dwordCount;
 
@@ -510,7 +642,7 @@ void AubFileStream::writeDiscontiguousPages(const std::vector<PageEntryInfo> &wr
                 ++itorDumpStart;
             }
         }
-        fileHandle.flush();
+        commitRecord();
     }
 }
 
@@ -527,7 +659,7 @@ void AubFileStream::writeMMIO(uint32_t offset, uint32_t value, uint32_t mask) {
     header.data[0] = value;
 
     write((char *)&header, sizeof(header));
-    fileHandle.flush();
+    commitRecord();
 }
 
 void AubFileStream::registerPoll(uint32_t registerOffset, uint32_t mask, uint32_t desiredValue, bool pollNotEqual, uint32_t timeoutAction) {
@@ -544,7 +676,7 @@ void AubFileStream::registerPoll(uint32_t registerOffset, uint32_t mask, uint32_
     header.dwordCount = (sizeof(header) / sizeof(uint32_t)) - 1;
 
     write((char *)&header, sizeof(header));
-    fileHandle.flush();
+    sync();
 }
 
 void AubFileStream::memoryPoll(const std::vector<PageInfo> &entries, uint32_t value, uint32_t compareMode) {
@@ -568,7 +700,7 @@ void AubFileStream::memoryPoll(const std::vector<PageInfo> &entries, uint32_t va
     header.data[0] = value;
 
     write((char *)&header, sizeof(header));
-    fileHandle.flush();
+    sync();
 }
 
 void AubFileStream::open(const char *name) {
@@ -577,13 +709,173 @@ void AubFileStream::open(const char *name) {
         assert(false);
     }
     fileName.assign(name);
+
+    writeBufferSize = globalSettings->AubFileBufferSizeKB.get() > 0 ? static_cast<size_t>(globalSettings->AubFileBufferSizeKB.get()) * 1024 : 0;
+    if (globalSettings->AubFileCompression.get() && writeBufferSize == 0) {
+        writeBufferSize = defaultCompressedChunkSize;
+    }
+    writeBuffer.clear();
+    writeBuffer.reserve(writeBufferSize);
+    elideRepeatedPages = globalSettings->AubFileElideRepeatedPages.get();
+    pageContentCache.reset();
+    if (globalSettings->AubFilePageCacheEntries.get() > 0) {
+        pageContentCache = std::make_unique<PageContentCache>(static_cast<size_t>(globalSettings->AubFilePageCacheEntries.get()));
+    }
+
+    if (globalSettings->AubFileCompression.get()) {
+        auto threadCount = globalSettings->AubFileCompressionThreads.get() > 0 ? static_cast<size_t>(globalSettings->AubFileCompressionThreads.get())
+                                                                               : std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 4);
+        compressedWriter = std::make_unique<CompressedFileWriter>(threadCount, [this](const char *buffer, size_t size) {
+            writeToFile(buffer, static_cast<std::streamsize>(size));
+        });
+    } else if (writeBufferSize && globalSettings->AubFileAsyncWriterQueueDepth.get() > 0) {
+        auto queueDepth = static_cast<size_t>(globalSettings->AubFileAsyncWriterQueueDepth.get());
+        asyncWriter = std::make_unique<AsyncFileWriter>(queueDepth, writeBufferSize, [this](const char *buffer, size_t size) {
+            writeToFile(buffer, static_cast<std::streamsize>(size));
+        });
+    }
+
+#ifndef _WIN32
+    // vectored writes bypass the stream, both handles append so records stay in order
+    if (globalSettings->AubFileVectoredWrites.get() && !isWriteOffloaded()) {
+        fileHandle.close();
+        fileHandle.open(name, std::ofstream::binary | std::ios::app);
+        fileDescriptor = ::open(name, O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            PRINT_LOG_ERROR("Failed to open file for vectored writes: %s (errno=%d: %s)\n", name, errno, strerror(errno));
+        }
+    }
+#endif
 }
 
 void AubFileStream::close() {
+    if (fileHandle.isOpen()) {
+        sync();
+        if (compressedWriter) {
+            compressedWriter->finish();
+        }
+        if (pageContentCache) {
+            PRINT_LOG_INFO("AUB file %s: %llu bytes of unchanged pages not rewritten\n", fileName.c_str(), static_cast<unsigned long long>(pageContentCache->getBytesSaved()));
+        }
+    }
+    asyncWriter.reset();
+    compressedWriter.reset();
     fileHandle.close();
+    closeFileDescriptor();
     fileName.clear();
 }
 
+void AubFileStream::sync() {
+    flushWriteBuffer();
+    if (asyncWriter) {
+        asyncWriter->drain();
+    }
+    if (compressedWriter) {
+        compressedWriter->drain();
+    }
+    fileHandle.flush();
+}
+
+void AubFileStream::flushWriteBuffer() {
+    if (writeBuffer.empty()) {
+        return;
+    }
+    if (compressedWriter) {
+        compressedWriter->push(writeBuffer);
+        return;
+    }
+    if (asyncWriter) {
+        asyncWriter->push(writeBuffer);
+        return;
+    }
+    writeToFile(writeBuffer.data(), static_cast<std::streamsize>(writeBuffer.size()));
+    writeBuffer.clear();
+}
+
+void AubFileStream::writeGathered(const WriteChunk *chunks, size_t count) {
+    size_t totalSize = 0;
+    for (size_t i = 0; i < count; i++) {
+        totalSize += chunks[i].size;
+    }
+
+    // records fitting the write buffer are cheaper to coalesce than to submit on their own
+    size_t written = 0;
+    if (fileDescriptor >= 0 && fileHandle.isOpen() && totalSize >= writeBufferSize) {
+        written = writeVectored(chunks, count);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (written >= chunks[i].size) {
+            written -= chunks[i].size;
+            continue;
+        }
+        write(chunks[i].data + written, static_cast<std::streamsize>(chunks[i].size - written));
+        written = 0;
+    }
+}
+
+size_t AubFileStream::writeVectored(const WriteChunk *chunks, size_t count) {
+    size_t totalWritten = 0;
+#ifndef _WIN32
+    // everything queued so far has to reach the file before the gathered record
+    flushWriteBuffer();
+    fileHandle.flush();
+
+    ScopedOperationTimer timer(OperationType::fileWrite);
+
+    std::vector<iovec> ioVectors;
+    ioVectors.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (chunks[i].size) {
+            ioVectors.push_back({const_cast<char *>(chunks[i].data), chunks[i].size});
+        }
+    }
+
+    size_t index = 0;
+    while (index < ioVectors.size()) {
+        auto batch = static_cast<int>(std::min(ioVectors.size() - index, static_cast<size_t>(IOV_MAX)));
+        auto result = ::writev(fileDescriptor, &ioVectors[index], batch);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // remaining data goes through write(), which handles EFAULT with a host copy
+            PRINT_LOG_VERBOSE("writev() failed, falling back to write() (errno=%d: %s)\n", errno, strerror(errno));
+            break;
+        }
+
+        auto bytes = static_cast<size_t>(result);
+        totalWritten += bytes;
+        while (index < ioVectors.size() && bytes >= ioVectors[index].iov_len) {
+            bytes -= ioVectors[index].iov_len;
+            ++index;
+        }
+        if (bytes) {
+            ioVectors[index].iov_base = static_cast<char *>(ioVectors[index].iov_base) + bytes;
+            ioVectors[index].iov_len -= bytes;
+        }
+    }
+    timer.setBytes(totalWritten);
+#endif
+    return totalWritten;
+}
+
+void AubFileStream::closeFileDescriptor() {
+#ifndef _WIN32
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+}
+
+void AubFileStream::commitRecord() {
+    // in buffered mode records stay in writeBuffer until it fills up or a sync point is reached
+    if (writeBufferSize == 0) {
+        fileHandle.flush();
+    }
+}
+
 bool AubFileStream::isOpen() {
     return fileHandle.isOpen();
 }
@@ -607,6 +899,26 @@ void AubFileStream::write(const char *buffer, std::streamsize size) {
         return;
     }
 
+    if (writeBufferSize) {
+        if (writeBuffer.size() + static_cast<size_t>(size) > writeBufferSize) {
+            flushWriteBuffer();
+        }
+        // payloads not fitting the buffer go straight to the file, keeping the EFAULT fallback below,
+        // with writer threads they are queued as an oversized chunk to keep the file owned by one thread
+        if (static_cast<size_t>(size) < writeBufferSize || isWriteOffloaded()) {
+            writeBuffer.insert(writeBuffer.end(), buffer, buffer + size);
+            if (writeBuffer.size() >= writeBufferSize) {
+                flushWriteBuffer();
+            }
+            return;
+        }
+    }
+
+    writeToFile(buffer, size);
+}
+
+void AubFileStream::writeToFile(const char *buffer, std::streamsize size) {
+    ScopedOperationTimer timer(OperationType::fileWrite, static_cast<uint64_t>(size));
     // First attempt: direct write
     fileHandle.write(buffer, static_cast<size_t>(size));
 
@@ -7,8 +7,12 @@
 
 #pragma once
 #include <fstream>
+#include "async_file_writer.h"
 #include "aub_stream.h"
+#include "compressed_file_writer.h"
+#include "page_content_cache.h"
 #include "settings.h"
+#include <memory>
 #include <string>
 
 namespace aub_stream {
@@ -82,6 +86,11 @@ struct FileHandleWrapper {
     bool throwOnError = false;
 };
 
+struct WriteChunk {
+    const char *data;
+    size_t size;
+};
+
 struct AubFileStream : public AubStream {
     virtual ~AubFileStream();
 
@@ -107,6 +116,8 @@ struct AubFileStream : public AubStream {
     bool isOpen();
     const std::string &getFileName();
     virtual void write(const char *buffer, std::streamsize size);
+    void sync();
+    uint64_t getDedupBytesSaved() const { return pageContentCache ? pageContentCache->getBytesSaved() : 0; }
 
     void enableThrowOnError(bool enabled) {
         fileHandle.throwOnError = enabled;
@@ -117,8 +128,37 @@ struct AubFileStream : public AubStream {
     friend AubTbxStream;
     friend AubShmStream;
     std::vector<char> tmpWriteBuffer; // buffer to hold data until file is opened
+    std::vector<char> writeBuffer;    // records coalesced before reaching the file when buffering is enabled
+    size_t writeBufferSize = 0;
+    std::unique_ptr<AsyncFileWriter> asyncWriter;           // drains full writeBuffer chunks on its own thread
+    std::unique_ptr<CompressedFileWriter> compressedWriter; // compresses full writeBuffer chunks into LZ4 frames
+    int fileDescriptor = -1;                      // append-mode descriptor used for vectored writes
+    bool elideRepeatedPages = false;              // uniform pages are written as repeat memory write records
+    std::unique_ptr<PageContentCache> pageContentCache; // skips pages rewritten with unchanged content
 
   protected:
+    static constexpr size_t defaultCompressedChunkSize = 1024 * 1024;
+    static constexpr size_t contentPageSize = static_cast<size_t>(PageContentCache::pageSize);
+    static constexpr size_t maxRepeatedMemorySize = 0x80000000;
+
+    void writeToFile(const char *buffer, std::streamsize size);
+    void flushWriteBuffer();
+    void commitRecord();
+    bool isWriteOffloaded() const { return asyncWriter || compressedWriter; }
+    void writeGathered(const WriteChunk *chunks, size_t count);
+    size_t writeVectored(const WriteChunk *chunks, size_t count);
+    void closeFileDescriptor();
+    void writeMemoryRecords(const uint8_t *memory, size_t size, uint64_t physAddress, int addressSpace, int hint);
+    enum class PageAction {
+        write,
+        skip,
+        repeat
+    };
+    PageAction classifyPages(const uint8_t *memory, size_t size, uint64_t physAddress, int addressSpace, uint32_t &repeatedValue);
+    void writeRepeatedMemoryRecord(uint32_t value, size_t size, uint64_t physAddress, int addressSpace, int hint);
+
+    std::vector<WriteChunk> gatherList;
+
     void writeGttPages(GGTT *ggtt, const std::vector<PageEntryInfo> &writeInfoTable) override;
 
     void expectMemoryTable(const void *memory, size_t size, const std::vector<PageInfo> &writeInfoTable, uint32_t compareOperation) override;
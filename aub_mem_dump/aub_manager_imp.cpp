@@ -15,6 +15,7 @@
 #include "aub_mem_dump/hardware_context_imp.h"
 #include "aub_mem_dump/null_hardware_context.h"
 #include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/metrics_registry.h"
 #include "aub_mem_dump/page_table.h"
 #include "aub_mem_dump/physical_address_allocator.h"
 #include "aub_mem_dump/tbx_shm_stream.h"
@@ -56,6 +57,10 @@ AubManagerImp::AubManagerImp(std::unique_ptr<Gpu> gpu, const struct AubManagerOp
                                                                this->gpu->getStolenMemorySize(options.memoryBankSize));
     this->gpu->programAdditionalEngineMMIO = options.programAdditionalEngineMMIO;
 
+    if (globalSettings->EnableOperationMetrics.get() || !globalSettings->OperationMetricsDumpFile.get().empty()) {
+        MetricsRegistry::get().enable(true);
+    }
+
     groupContextHelper = std::make_unique<GroupContextHelper>();
     auto contextGroupCount = this->gpu->getContextGroupCount();
 
@@ -246,6 +251,25 @@ void AubManagerImp::close() {
     if (streamAub) {
         streamAub->close();
     }
+
+    auto metricsFile = globalSettings->OperationMetricsDumpFile.get();
+    if (!metricsFile.empty() && !MetricsRegistry::get().dumpToFile(metricsFile)) {
+        PRINT_LOG_ERROR("Failed to write operation metrics to %s\n", metricsFile.c_str());
+    }
+}
+
+void AubManagerImp::flush() {
+    if (streamAub && streamAub->isOpen()) {
+        streamAub->sync();
+    }
+}
+
+std::vector<OperationMetrics> AubManagerImp::getOperationMetrics() {
+    return MetricsRegistry::get().getOperationMetrics();
+}
+
+void AubManagerImp::resetOperationMetrics() {
+    MetricsRegistry::get().reset();
 }
 
 bool AubManagerImp::isOpen() {
@@ -423,12 +447,13 @@ void AubManagerImp::writeMemory2(AllocationParams allocationParams) {
     if (streamMode == aub_stream::mode::null) {
         return;
     }
+    ScopedOperationTimer timer(OperationType::writeMemory2, allocationParams.size);
     auto &csTraits = gpu->getCommandStreamerHelper(0, static_cast<EngineType>(ENGINE_CCS));
     allocationParams.pageSize = csTraits.getSupportedPageSize(allocationParams.memoryBanks, allocationParams.pageSize);
 
     AubStream *stream = getStream();
 
-    auto pageTableEntries = stream->writeMemory(ppgtts[0].get(), allocationParams);
+    const auto &pageTableEntries = stream->writeMemory(ppgtts[0].get(), allocationParams);
 
     for (uint32_t i = 1; i < ppgtts.size(); i++) {
         stream->cloneMemory(ppgtts[i].get(), pageTableEntries, allocationParams);
@@ -445,7 +470,7 @@ void AubManagerImp::writePageTableEntries(uint64_t gfxAddress, size_t size, uint
     pageSize = csTraits.getSupportedPageSize(memoryBanks, pageSize);
     AubStream *stream = getStream();
 
-    auto pageTableEntries = stream->writeMemory(ppgtts[0].get(), AllocationParams(gfxAddress, nullptr, size, memoryBanks, hint, pageSize));
+    const auto &pageTableEntries = stream->writeMemory(ppgtts[0].get(), AllocationParams(gfxAddress, nullptr, size, memoryBanks, hint, pageSize));
 
     for (uint32_t i = 1; i < ppgtts.size(); i++) {
         stream->cloneMemory(ppgtts[i].get(), pageTableEntries, AllocationParams(gfxAddress, nullptr, size, memoryBanks, 0, pageSize));
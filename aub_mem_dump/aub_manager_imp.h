@@ -83,6 +83,9 @@ class AubManagerImp : public AubManager {
     bool releaseHardwareContext(HardwareContext *context) override;
 
     void closeSocket(void) override;
+    void flush() override;
+    std::vector<OperationMetrics> getOperationMetrics() override;
+    void resetOperationMetrics() override;
 
   protected:
     virtual void createStream();
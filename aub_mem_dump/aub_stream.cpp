@@ -7,7 +7,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <cstdio>
 #include <sstream>
+#include <stdexcept>
 #include "aub_mem_dump/aub_stream.h"
 #include "aub_mem_dump/memory_banks.h"
 #include "aub_mem_dump/memory_bank_helper.h"
@@ -18,106 +21,114 @@
 
 namespace aub_stream {
 
+namespace {
+
+// Page entries of the last writeMemory on this thread, swapped with the buffer of a pooled walker on every write
+thread_local std::vector<PageInfo> lastWrittenEntries;
+
+// Writes "<prefix><start> - <end>  pageSize: <pageSize>  banks: bank0 bank1" with values in hex with a 0x prefix,
+// formatted on the stack as every write adds this comment
+template <size_t bufferSize>
+const char *formatWriteComment(char (&comment)[bufferSize], const char *prefix, uint64_t gfxAddress, size_t size, size_t pageSize, uint32_t memoryBanks) {
+    auto length = static_cast<size_t>(snprintf(comment, bufferSize, "%s%#" PRIx64 " - %#" PRIx64 "  pageSize: %#zx  banks:",
+                                               prefix, gfxAddress, gfxAddress + size - 1, pageSize));
+    if (memoryBanks == 0) {
+        snprintf(comment + length, bufferSize - length, " sys");
+    }
+    for (uint32_t bank = 0; memoryBanks != 0 && length < bufferSize; bank++, memoryBanks >>= 1) {
+        if (memoryBanks & 1) {
+            length += static_cast<size_t>(snprintf(comment + length, bufferSize - length, " bank%u", bank));
+        }
+    }
+    return comment;
+}
+
+} // namespace
+
 void AubStream::gttMemoryPoll(GGTT *ggtt, uint64_t gfxAddress, uint32_t value, uint32_t compareMode) {
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ggtt, gfxAddress, sizeof(value), PhysicalAddressAllocator::mainBank, ggtt->getPageSize(), PageTableWalker::WalkMode::Expect, nullptr);
-    memoryPoll(pageWalker.entries, value, compareMode);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ggtt, gfxAddress, sizeof(value), PhysicalAddressAllocator::mainBank, ggtt->getPageSize(), PageTableWalker::WalkMode::Expect, nullptr);
+    memoryPoll(pageWalker->entries, value, compareMode);
 }
 
 void AubStream::expectMemory(GGTT *ggtt, uint64_t gfxAddress, const void *memory, size_t size, uint32_t compareOperation) {
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ggtt, gfxAddress, size, PhysicalAddressAllocator::mainBank, ggtt->getPageSize(), PageTableWalker::WalkMode::Expect, nullptr);
-    expectMemoryTable(memory, size, pageWalker.entries, compareOperation);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ggtt, gfxAddress, size, PhysicalAddressAllocator::mainBank, ggtt->getPageSize(), PageTableWalker::WalkMode::Expect, nullptr);
+    expectMemoryTable(memory, size, pageWalker->entries, compareOperation);
 }
 
 void AubStream::expectMemory(PageTable *ppgtt, uint64_t gfxAddress, const void *memory, size_t size, uint32_t compareOperation) {
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ppgtt, {gfxAddress, nullptr, size, PhysicalAddressAllocator::mainBank, 0, 65536}, PageTableWalker::WalkMode::Expect, nullptr);
-    expectMemoryTable(memory, size, pageWalker.entries, compareOperation);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ppgtt, {gfxAddress, nullptr, size, PhysicalAddressAllocator::mainBank, 0, 65536}, PageTableWalker::WalkMode::Expect, nullptr);
+    expectMemoryTable(memory, size, pageWalker->entries, compareOperation);
 }
 
 void AubStream::readMemory(PageTable *ppgtt, uint64_t gfxAddress, void *memory, size_t size, uint32_t memoryBanks, size_t pageSize) {
     assert(ppgtt->getNumLevels() > 1);
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ppgtt, {gfxAddress, nullptr, size, memoryBanks, 0, pageSize}, PageTableWalker::WalkMode::Expect, nullptr);
-    readDiscontiguousPages(memory, size, pageWalker.entries);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ppgtt, {gfxAddress, nullptr, size, memoryBanks, 0, pageSize}, PageTableWalker::WalkMode::Expect, nullptr);
+    readDiscontiguousPages(memory, size, pageWalker->entries);
 }
 
 void AubStream::readMemory(GGTT *ggtt, uint64_t gfxAddress, void *memory, size_t size, uint32_t memoryBanks, size_t pageSize) {
-    PageTableWalker pageWalker;
+    PooledPageTableWalker pageWalker;
 
-    pageWalker.walkMemory(ggtt, gfxAddress, size, memoryBanks, pageSize, PageTableWalker::WalkMode::Expect, nullptr);
-    readDiscontiguousPages(memory, size, pageWalker.entries);
+    pageWalker->walkMemory(ggtt, gfxAddress, size, memoryBanks, pageSize, PageTableWalker::WalkMode::Expect, nullptr);
+    readDiscontiguousPages(memory, size, pageWalker->entries);
 }
 
-std::vector<PageInfo> AubStream::writeMemory(GGTT *ggtt, uint64_t gfxAddress, const void *memory, size_t size, uint32_t memoryBanks, int hint, size_t pageSize) {
-    std::ostringstream str;
-    str << "ggtt: " << std::hex << std::showbase << gfxAddress
-        << " - " << gfxAddress + size - 1
-        << "  pageSize: " << pageSize
-        << "  banks:"
-        << memoryBanksToString(memoryBanks, " ");
-
-    addComment(str.str().c_str());
+const std::vector<PageInfo> &AubStream::writeMemory(GGTT *ggtt, uint64_t gfxAddress, const void *memory, size_t size, uint32_t memoryBanks, int hint, size_t pageSize) {
+    char comment[512];
+    addComment(formatWriteComment(comment, "ggtt: ", gfxAddress, size, pageSize, memoryBanks));
 
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ggtt, gfxAddress, size, memoryBanks, pageSize, PageTableWalker::WalkMode::Reserve, nullptr);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ggtt, gfxAddress, size, memoryBanks, pageSize, PageTableWalker::WalkMode::Reserve, nullptr);
 
-    writeGttPages(ggtt, pageWalker.pageWalkEntries[0]);
+    writeGttPages(ggtt, pageWalker->pageWalkEntries[0]);
 
     if (memory) {
-        writeDiscontiguousPages(memory, size, pageWalker.entries, hint);
+        writeDiscontiguousPages(memory, size, pageWalker->entries, hint);
     }
-    return pageWalker.entries;
+    lastWrittenEntries.swap(pageWalker->entries);
+    return lastWrittenEntries;
 }
 
-std::vector<PageInfo> AubStream::writeMemory(PageTable *ppgtt, const AllocationParams &allocationParams) {
+const std::vector<PageInfo> &AubStream::writeMemory(PageTable *ppgtt, const AllocationParams &allocationParams) {
     auto memory = allocationParams.memory;
     auto gfxAddress = allocationParams.gfxAddress;
     auto size = allocationParams.size;
-    std::ostringstream str;
-    str << "ppgtt" << (memory == nullptr ? "(pages only): " : ":") << std::hex << std::showbase << gfxAddress
-        << " - " << gfxAddress + size - 1
-        << "  pageSize: " << allocationParams.pageSize
-        << "  banks:"
-        << memoryBanksToString(allocationParams.memoryBanks, " ");
-
-    addComment(str.str().c_str());
+    char comment[512];
+    addComment(formatWriteComment(comment, memory == nullptr ? "ppgtt(pages only): " : "ppgtt:", gfxAddress, size, allocationParams.pageSize, allocationParams.memoryBanks));
 
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ppgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ppgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr);
 
-    writePages(pageWalker, memory, size, allocationParams.hint, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
+    writePages(*pageWalker, memory, size, allocationParams.hint, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
 
-    return pageWalker.entries;
+    lastWrittenEntries.swap(pageWalker->entries);
+    return lastWrittenEntries;
 }
 
 void AubStream::writeMemoryAndClonePageTables(PageTable *ppgtt, PageTable *ppgttForCloning[], uint32_t ppggtForCloningCount, uint64_t gfxAddress, const void *memory, size_t size, uint32_t memoryBanks, int hint, size_t pageSize) {
-    std::ostringstream str;
-    str << "ppgtt: " << std::hex << std::showbase << gfxAddress
-        << " - " << gfxAddress + size - 1
-        << "  pageSize: " << pageSize
-        << "  banks:"
-        << memoryBanksToString(memoryBanks, " ");
-
-    addComment(str.str().c_str());
+    char comment[512];
+    addComment(formatWriteComment(comment, "ppgtt: ", gfxAddress, size, pageSize, memoryBanks));
 
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ppgtt, {gfxAddress, memory, size, memoryBanks, hint, pageSize}, PageTableWalker::WalkMode::Reserve, nullptr);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ppgtt, {gfxAddress, memory, size, memoryBanks, hint, pageSize}, PageTableWalker::WalkMode::Reserve, nullptr);
 
-    writePages(pageWalker, memory, size, hint, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
+    writePages(*pageWalker, memory, size, hint, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
 
     for (uint32_t i = 0; i < ppggtForCloningCount; i++) {
-        cloneMemory(ppgttForCloning[i], pageWalker.entries, {gfxAddress, memory, size, memoryBanks, hint, pageSize});
+        cloneMemory(ppgttForCloning[i], pageWalker->entries, {gfxAddress, memory, size, memoryBanks, hint, pageSize});
     }
 }
 
 void AubStream::cloneMemory(PageTable *ppgtt, const std::vector<PageInfo> &entries, const AllocationParams &allocationParams) {
     assert(ppgtt->getNumLevels() > 1);
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ppgtt, allocationParams, PageTableWalker::WalkMode::Clone, &entries);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ppgtt, allocationParams, PageTableWalker::WalkMode::Clone, &entries);
 
-    writePages(pageWalker, nullptr, 0, 0, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
+    writePages(*pageWalker, nullptr, 0, 0, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
 }
 
 void AubStream::freeMemory(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
@@ -125,7 +136,10 @@ void AubStream::freeMemory(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
     assert(size != 0);
     constexpr size_t page64kSize = 65536u;
 
-    std::vector<PageEntryInfo> pageWalkEntries[3];
+    ppgtt->invalidateTranslations(gfxAddress, size);
+
+    PooledPageTableWalker scratchWalker;
+    auto &pageWalkEntries = scratchWalker->pageWalkEntries;
 
     // Reserve minimal # of entries
     pageWalkEntries[PageTableLevel::Pte].reserve(2 + (uint64_t(size) / page64kSize));
@@ -162,6 +176,48 @@ void AubStream::freeMemory(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
             // PTE is only valid if level == PageTableLevel::Pte
             pte = (level != PageTableLevel::Pte) ? nullptr : static_cast<PTE *>(parent);
 
+            if (level == PageTableLevel::Pte) {
+                assert(pte != nullptr);
+                auto leaf = pte->getLeaf(index);
+                if (leaf) {
+                    const bool wasPs64 = leaf->isPs64();
+
+                    // remove page from PTE
+                    pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + index * sizeof(uint64_t), 0});
+
+                    if (wasPs64) {
+                        assert(globalSettings->EnablePs64.get());
+                        assert(ppgtt->getNumLevels() == 5);
+
+                        const uint32_t hwBase = index & ~0xfu;
+                        // First PTE of the request: if start is not 64KB-aligned, the group is
+                        // brokeen from TLB perspective - correct slots before the free range start
+                        if (gfxAddress == startAddress && !isStartAddress64KBAligned) {
+                            for (uint32_t i = hwBase; i < index; i++) {
+                                if (PageTableLeaf *ci = pte->getLeaf(i)) {
+                                    ci->setPs64(false);
+                                    pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + i * sizeof(uint64_t), pte->getLeafEntryValue(i)});
+                                }
+                            }
+                        }
+                        // Last PTE of the request: if end is not 64KB-aligned, the group is
+                        // brokeen from TLB perspective - correct slots after the free range end
+                        if (size <= 4096 && !isEndAddress64KBAligned) {
+                            for (uint32_t i = index + 1; i < hwBase + 16; i++) {
+                                if (PageTableLeaf *ci = pte->getLeaf(i)) {
+                                    ci->setPs64(false);
+                                    pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + i * sizeof(uint64_t), pte->getLeafEntryValue(i)});
+                                }
+                            }
+                        }
+                    }
+
+                    // Free physical page
+                    pte->releaseLeaf(index);
+                }
+                break;
+            }
+
             // Get each of the page structures
             child = parent->getChild(index);
             if (level == PageTableLevel::Pde && child) {
@@ -171,43 +227,6 @@ void AubStream::freeMemory(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
                     break;
                 }
             }
-
-            if (child && level == PageTableLevel::Pte) {
-                assert(pte != nullptr);
-
-                const bool wasPs64 = child->isPs64();
-
-                // remove page from PTE
-                pte->setChild(index, nullptr);
-                pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + index * sizeof(uint64_t), 0});
-
-                if (wasPs64) {
-                    assert(globalSettings->EnablePs64.get());
-                    assert(ppgtt->getNumLevels() == 5);
-
-                    const uint32_t hwBase = index & ~0xfu;
-                    // First PTE of the request: if start is not 64KB-aligned, the group is
-                    // brokeen from TLB perspective - correct slots before the free range start
-                    if (gfxAddress == startAddress && !isStartAddress64KBAligned) {
-                        for (uint32_t i = hwBase; i < index; i++) {
-                            if (PageTable *ci = pte->getChild(i)) {
-                                ci->setPs64(false);
-                                pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + i * sizeof(uint64_t), ci->getEntryValue()});
-                            }
-                        }
-                    }
-                    // Last PTE of the request: if end is not 64KB-aligned, the group is
-                    // brokeen from TLB perspective - correct slots after the free range end
-                    if (size <= 4096 && !isEndAddress64KBAligned) {
-                        for (uint32_t i = index + 1; i < hwBase + 16; i++) {
-                            if (PageTable *ci = pte->getChild(i)) {
-                                ci->setPs64(false);
-                                pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + i * sizeof(uint64_t), ci->getEntryValue()});
-                            }
-                        }
-                    }
-                }
-            }
             --level;
         }
 
@@ -227,7 +246,7 @@ void AubStream::freeMemory(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
             pageWalkEntries[PageTableLevel::Pde].push_back(info);
 
             // Delete 2MB page
-            delete child;
+            ppgtt->getArena().destroy(child);
 
             // Clean up empty PDE
             if (pdp && pde->isEmpty()) {
@@ -238,16 +257,13 @@ void AubStream::freeMemory(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
                     0,
                 };
                 pageWalkEntries[PageTableLevel::Pdp].push_back(info1);
-                delete pde;
+                ppgtt->getArena().destroy(pde);
             }
         } else {
             assert(pte);
             pageSizeThisIteration = pte->getPageSize(); // NOLINT(clang-analyzer-core.CallAndMessage)
             assert(pageSizeThisIteration == 4096 || pageSizeThisIteration == 65536);
 
-            // Delete physical page
-            delete child;
-
             if (pde && pte->isEmpty()) {
                 // remove PTE
                 pde->setChild(pde->getIndex(gfxAddress), nullptr);
@@ -256,7 +272,7 @@ void AubStream::freeMemory(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
                     0,
                 };
                 pageWalkEntries[PageTableLevel::Pde].push_back(info1);
-                delete pte;
+                ppgtt->getArena().destroy(pte);
             }
         }
 
@@ -301,10 +317,10 @@ void AubStream::writePhysicalMemoryPages(const void *memory, size_t size, const
 }
 
 bool AubStream::mapGpuVa(PageTable *ppgtt, AllocationParams allocationParams, uint64_t physicalAddress) {
-    PageTableWalker pageWalker;
-    pageWalker.walkMemory(ppgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr, physicalAddress);
+    PooledPageTableWalker pageWalker;
+    pageWalker->walkMemory(ppgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr, physicalAddress);
 
-    writePages(pageWalker, nullptr, 0, allocationParams.hint, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
+    writePages(*pageWalker, nullptr, 0, allocationParams.hint, ppgtt->isLocalMemory(), ppgtt->getNumAddressBits());
 
     return true;
 }
@@ -335,6 +351,9 @@ void AubStream::writePageWalkEntries(const PageTableWalker &pageWalker, bool pag
                 node->setPendingWrite(false);
             }
         }
+        for (auto *leaf : pageWalker.pendingLeaves) {
+            leaf->setPendingWrite(false);
+        }
     }
 }
 
@@ -392,4 +411,13 @@ bool AubStream::compareMemory(uint32_t readValue, uint32_t expectedValue, uint32
     return matches;
 }
 
+void AubStream::handlePollTimeout(const char *pollType, uint64_t address, uint32_t timeoutAction) {
+    if (timeoutAction == CmdServicesMemTraceRegisterPoll::TimeoutActionValues::Ignore) {
+        PRINT_LOG_VERBOSE("%s poll at 0x%llx timed out, ignored\n", pollType, static_cast<unsigned long long>(address));
+        return;
+    }
+    PRINT_LOG_ERROR("%s poll at 0x%llx timed out\n", pollType, static_cast<unsigned long long>(address));
+    throw std::runtime_error(std::string(pollType) + " poll timed out");
+}
+
 } // namespace aub_stream
@@ -41,8 +41,9 @@ struct AubStream {
     void readMemory(PageTable *ppgtt, uint64_t gfxAddress, void *memory, size_t size, uint32_t memoryBanks, size_t pageSize);
     void readMemory(GGTT *gtt, uint64_t gfxAddress, void *memory, size_t size, uint32_t memoryBanks, size_t pageSize);
 
-    std::vector<PageInfo> writeMemory(GGTT *ggtt, uint64_t gfxAddress, const void *memory, size_t size, uint32_t memoryBanks, int hint, size_t pageSize = 4096);
-    std::vector<PageInfo> writeMemory(PageTable *ppgtt, const AllocationParams &allocationParams);
+    // Return the pages written, valid until the next writeMemory on the calling thread
+    const std::vector<PageInfo> &writeMemory(GGTT *ggtt, uint64_t gfxAddress, const void *memory, size_t size, uint32_t memoryBanks, int hint, size_t pageSize = 4096);
+    const std::vector<PageInfo> &writeMemory(PageTable *ppgtt, const AllocationParams &allocationParams);
 
     virtual bool mapGpuVa(PageTable *ppgtt, AllocationParams allocationParams, uint64_t physicalAddress);
 
@@ -90,6 +91,7 @@ struct AubStream {
     virtual void memoryPoll(const std::vector<PageInfo> &entries, uint32_t value, uint32_t compareMode) = 0;
 
     bool compareMemory(uint32_t readValue, uint32_t expectedValue, uint32_t compareOperation);
+    void handlePollTimeout(const char *pollType, uint64_t address, uint32_t timeoutAction);
     bool dumpBinSupported = false;
     bool dumpSurfaceSupported = false;
 };
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "compressed_file_writer.h"
+#include "hash_helpers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace aub_stream {
+
+namespace lz4 {
+constexpr size_t minMatch = 4;
+constexpr size_t lastLiterals = 5;    // block must end with at least 5 literals
+constexpr size_t matchFindLimit = 12; // last match must start at least 12 bytes before block end
+constexpr size_t maxOffset = 0xFFFF;
+constexpr uint32_t hashLog = 16;
+
+static uint32_t read32(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static void write32(std::vector<char> &output, uint32_t value) {
+    char bytes[sizeof(value)];
+    memcpy(bytes, &value, sizeof(value));
+    output.insert(output.end(), bytes, bytes + sizeof(bytes));
+}
+
+static uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - hashLog);
+}
+
+static uint8_t *writeLength(uint8_t *op, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *op++ = 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+static uint8_t *writeSequence(uint8_t *op, const uint8_t *literals, size_t literalLength, size_t offset, size_t matchLength) {
+    auto token = op++;
+    *token = static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4);
+    if (literalLength >= 15) {
+        op = writeLength(op, literalLength - 15);
+    }
+    memcpy(op, literals, literalLength);
+    op += literalLength;
+
+    if (matchLength) {
+        *op++ = static_cast<uint8_t>(offset);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        auto encodedMatchLength = matchLength - minMatch;
+        *token |= static_cast<uint8_t>(std::min<size_t>(encodedMatchLength, 15));
+        if (encodedMatchLength >= 15) {
+            op = writeLength(op, encodedMatchLength - 15);
+        }
+    }
+    return op;
+}
+
+size_t getMaxCompressedBlockSize(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t compressBlock(const uint8_t *src, size_t size, uint8_t *dst, std::vector<uint32_t> &hashTable) {
+    // entries hold position + 1, zero marks an empty slot
+    hashTable.assign(size_t(1) << hashLog, 0);
+
+    auto op = dst;
+    size_t anchor = 0;
+    size_t position = 0;
+
+    if (size > matchFindLimit) {
+        const auto searchLimit = size - matchFindLimit;
+        const auto matchLimit = size - lastLiterals;
+
+        while (position < searchLimit) {
+            auto sequence = read32(src + position);
+            auto &entry = hashTable[hashSequence(sequence)];
+            auto reference = static_cast<size_t>(entry);
+            entry = static_cast<uint32_t>(position + 1);
+
+            if (reference == 0 || position - (reference - 1) > maxOffset || read32(src + reference - 1) != sequence) {
+                ++position;
+                continue;
+            }
+            reference--;
+
+            auto matchLength = minMatch;
+            while (position + matchLength < matchLimit && src[reference + matchLength] == src[position + matchLength]) {
+                ++matchLength;
+            }
+
+            op = writeSequence(op, src + anchor, position - anchor, position - reference, matchLength);
+            position += matchLength;
+            anchor = position;
+        }
+    }
+
+    op = writeSequence(op, src + anchor, size - anchor, 0, 0);
+    return static_cast<size_t>(op - dst);
+}
+
+void appendFrame(std::vector<char> &output, const char *src, size_t size, std::vector<uint32_t> &hashTable) {
+    write32(output, frameMagic);
+
+    // version 01, independent blocks, content size present; 4MB maximum block size
+    uint8_t descriptor[2 + sizeof(uint64_t)] = {0x68, 0x70};
+    uint64_t contentSize = size;
+    memcpy(descriptor + 2, &contentSize, sizeof(contentSize));
+    output.insert(output.end(), reinterpret_cast<char *>(descriptor), reinterpret_cast<char *>(descriptor) + sizeof(descriptor));
+    output.push_back(static_cast<char>((xxHash32(descriptor, sizeof(descriptor)) >> 8) & 0xFF));
+
+    for (size_t offset = 0; offset < size; offset += maxBlockSize) {
+        auto blockSize = std::min(maxBlockSize, size - offset);
+        auto blockHeaderPosition = output.size();
+        write32(output, 0);
+
+        auto dataPosition = output.size();
+        output.resize(dataPosition + getMaxCompressedBlockSize(blockSize));
+        auto compressedSize = compressBlock(reinterpret_cast<const uint8_t *>(src + offset), blockSize,
+                                            reinterpret_cast<uint8_t *>(output.data() + dataPosition), hashTable);
+
+        uint32_t blockHeader = static_cast<uint32_t>(compressedSize);
+        if (compressedSize >= blockSize) {
+            memcpy(output.data() + dataPosition, src + offset, blockSize);
+            compressedSize = blockSize;
+            blockHeader = static_cast<uint32_t>(blockSize) | uncompressedBlockFlag;
+        }
+        output.resize(dataPosition + compressedSize);
+        memcpy(output.data() + blockHeaderPosition, &blockHeader, sizeof(blockHeader));
+    }
+
+    write32(output, 0); // end mark
+}
+} // namespace lz4
+
+CompressedFileWriter::CompressedFileWriter(size_t workerCount, WriteFunction writeFunction)
+    : slots(2 * std::max<size_t>(workerCount, 1)), writeFunction(std::move(writeFunction)) {
+    for (size_t i = 0; i < std::max<size_t>(workerCount, 1); i++) {
+        workers.emplace_back(&CompressedFileWriter::run, this);
+    }
+}
+
+CompressedFileWriter::~CompressedFileWriter() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotStateChanged.wait(lock, [&] { return nextToWrite == nextToSubmit; });
+        stopRequested = true;
+    }
+    slotStateChanged.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void CompressedFileWriter::push(std::vector<char> &chunk) {
+    if (chunk.empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    assert(!finished);
+    rethrowPendingError();
+
+    auto &slot = slots[nextToSubmit % slots.size()];
+    slotStateChanged.wait(lock, [&] { return slot.state == SlotState::free; });
+
+    // slot input was cleared after its frame got written, swapping recycles its capacity
+    slot.input.swap(chunk);
+    slot.state = SlotState::pending;
+    nextToSubmit++;
+    lock.unlock();
+    slotStateChanged.notify_all();
+}
+
+void CompressedFileWriter::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    slotStateChanged.wait(lock, [&] { return nextToWrite == nextToSubmit; });
+    rethrowPendingError();
+}
+
+void CompressedFileWriter::finish() {
+    drain();
+    if (finished) {
+        return;
+    }
+    finished = true;
+
+    std::vector<char> indexFrame;
+    uint32_t payloadSize = static_cast<uint32_t>(3 * sizeof(uint32_t) + frameIndex.size() * sizeof(FrameIndexEntry));
+    uint32_t frameSize = static_cast<uint32_t>(2 * sizeof(uint32_t)) + payloadSize;
+    uint32_t header[] = {lz4::skippableFrameMagic, payloadSize, lz4::frameIndexVersion, static_cast<uint32_t>(frameIndex.size())};
+
+    indexFrame.insert(indexFrame.end(), reinterpret_cast<char *>(header), reinterpret_cast<char *>(header) + sizeof(header));
+    indexFrame.insert(indexFrame.end(), reinterpret_cast<const char *>(frameIndex.data()), reinterpret_cast<const char *>(frameIndex.data() + frameIndex.size()));
+    indexFrame.insert(indexFrame.end(), reinterpret_cast<char *>(&frameSize), reinterpret_cast<char *>(&frameSize) + sizeof(frameSize));
+    assert(indexFrame.size() == frameSize);
+
+    writeFunction(indexFrame.data(), indexFrame.size());
+}
+
+void CompressedFileWriter::run() {
+    std::vector<uint32_t> hashTable;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        slotStateChanged.wait(lock, [&] { return stopRequested || nextToCompress != nextToSubmit; });
+        if (nextToCompress == nextToSubmit) {
+            break;
+        }
+
+        auto &slot = slots[nextToCompress++ % slots.size()];
+        lock.unlock();
+        slot.output.clear();
+        lz4::appendFrame(slot.output, slot.input.data(), slot.input.size(), hashTable);
+        lock.lock();
+
+        slot.state = SlotState::compressed;
+        writeCompletedFrames(lock);
+    }
+}
+
+void CompressedFileWriter::writeCompletedFrames(std::unique_lock<std::mutex> &lock) {
+    // only one worker writes at a time, frames leave in submission order
+    if (writing) {
+        return;
+    }
+    writing = true;
+    while (nextToWrite != nextToCompress && slots[nextToWrite % slots.size()].state == SlotState::compressed) {
+        auto &slot = slots[nextToWrite % slots.size()];
+        frameIndex.push_back({uncompressedOffset, compressedOffset});
+
+        // errors are sticky, frames following a failed write are dropped
+        bool skipWrite = pendingError != nullptr;
+        std::exception_ptr error;
+        lock.unlock();
+        if (!skipWrite) {
+            try {
+                writeFunction(slot.output.data(), slot.output.size());
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        lock.lock();
+        if (error) {
+            pendingError = error;
+        }
+
+        uncompressedOffset += slot.input.size();
+        compressedOffset += slot.output.size();
+        slot.input.clear();
+        slot.state = SlotState::free;
+        nextToWrite++;
+        slotStateChanged.notify_all();
+    }
+    writing = false;
+}
+
+void CompressedFileWriter::rethrowPendingError() {
+    if (pendingError && !errorReported) {
+        errorReported = true;
+        std::rethrow_exception(pendingError);
+    }
+}
+
+} // namespace aub_stream
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aub_stream {
+
+namespace lz4 {
+constexpr uint32_t frameMagic = 0x184D2204;
+constexpr uint32_t skippableFrameMagic = 0x184D2A50;
+constexpr uint32_t uncompressedBlockFlag = 0x80000000;
+constexpr size_t maxBlockSize = 4 * 1024 * 1024;
+constexpr uint32_t frameIndexVersion = 1;
+
+size_t getMaxCompressedBlockSize(size_t size);
+size_t compressBlock(const uint8_t *src, size_t size, uint8_t *dst, std::vector<uint32_t> &hashTable);
+void appendFrame(std::vector<char> &output, const char *src, size_t size, std::vector<uint32_t> &hashTable);
+} // namespace lz4
+
+// Compresses AUB chunks into independently decodable LZ4 frames on a pool of worker threads.
+// Frames are written in submission order; finish() appends a skippable frame holding the frame index
+// (uncompressed and compressed offset of every frame), its last dword is the index frame size so
+// readers can locate it from the end of the file.
+struct CompressedFileWriter {
+    using WriteFunction = std::function<void(const char *buffer, size_t size)>;
+
+    struct FrameIndexEntry {
+        uint64_t uncompressedOffset;
+        uint64_t compressedOffset;
+    };
+
+    CompressedFileWriter(size_t workerCount, WriteFunction writeFunction);
+    ~CompressedFileWriter();
+
+    CompressedFileWriter(const CompressedFileWriter &) = delete;
+    CompressedFileWriter &operator=(const CompressedFileWriter &) = delete;
+
+    void push(std::vector<char> &chunk);
+    void drain();
+    void finish();
+
+    const std::vector<FrameIndexEntry> &getFrameIndex() const { return frameIndex; }
+    size_t getWorkerCount() const { return workers.size(); }
+
+  protected:
+    enum class SlotState {
+        free,
+        pending,
+        compressed
+    };
+    struct Slot {
+        std::vector<char> input;
+        std::vector<char> output;
+        SlotState state = SlotState::free;
+    };
+
+    void run();
+    void writeCompletedFrames(std::unique_lock<std::mutex> &lock);
+    void rethrowPendingError();
+
+    std::vector<Slot> slots;
+    std::vector<std::thread> workers;
+    WriteFunction writeFunction;
+
+    std::mutex mutex;
+    std::condition_variable slotStateChanged;
+    uint64_t nextToSubmit = 0;
+    uint64_t nextToCompress = 0;
+    uint64_t nextToWrite = 0;
+    bool writing = false;
+    bool stopRequested = false;
+    bool finished = false;
+
+    uint64_t uncompressedOffset = 0;
+    uint64_t compressedOffset = 0;
+    std::vector<FrameIndexEntry> frameIndex;
+    std::exception_ptr pendingError;
+    bool errorReported = false;
+};
+
+} // namespace aub_stream
@@ -10,13 +10,13 @@
 #include "aub_mem_dump/command_streamer_helper.h"
 #include "aub_mem_dump/gpu.h"
 #include "aub_mem_dump/hardware_context_imp.h"
+#include "aub_mem_dump/metrics_registry.h"
 #include "aub_mem_dump/page_table.h"
+#include "aub_mem_dump/poll_helper.h"
 #include "aub_mem_dump/settings.h"
 #include <atomic>
 #include <vector>
 #include <inttypes.h>
-#include <chrono>
-#include <thread>
 
 namespace aub_stream {
 
@@ -203,6 +203,7 @@ void HardwareContextImp::release() {
 }
 
 void HardwareContextImp::pollForCompletion() {
+    ScopedOperationTimer timer(OperationType::pollForCompletion);
     if (csTraits.memoryBasedPollForCompletion()) {
         stream.gttMemoryPoll(&ggtt, ggttContextFence, contextFenceValue, CmdServicesMemTraceMemoryPoll::ComparisonValues::GreaterEqual);
     } else {
@@ -216,22 +217,18 @@ void HardwareContextImp::pollForFenceCompletion() {
                           ? 65536u
                           : 4096u;
 
-    uint32_t sleepMS = 1;
-    uint32_t spinCount = 0;
-    constexpr uint32_t maxSpinCount = 16;
-    constexpr uint32_t maxSleepMS = 4;
-
-    do {
-        if (spinCount >= maxSpinCount) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleepMS));
-            // Exponential sleep time, capped by maxSleepMS.
-            sleepMS = std::min(maxSleepMS, sleepMS << 1);
-        } else {
-            ++spinCount;
-        }
+    PollPolicy policy;
+    policy.spinCount = 16;
+    policy.yieldCount = 0;
+    policy.initialSleepMicroseconds = 1000;
+    policy.maxSleepMicroseconds = 4000;
+    PollStatistics statistics;
+
+    poll(policy, statistics, [&]() {
         std::atomic_thread_fence(std::memory_order_acquire);
         stream.readMemory(&ggtt, ggttContextFence, &currentValue, sizeof(currentValue), ggtt.getMemoryBank(), pageSize);
-    } while (currentValue != contextFenceValue);
+        return currentValue == contextFenceValue ? PollStatus::matched : PollStatus::pending;
+    });
 }
 
 void HardwareContextImp::writeAndSubmitBatchBuffer(uint64_t gfxAddress, const void *batchBuffer, size_t size, uint32_t memoryBanks, size_t pageSize) {
@@ -249,6 +246,7 @@ void HardwareContextImp::writeAndSubmitBatchBuffer(uint64_t gfxAddress, const vo
 }
 
 void HardwareContextImp::submitBatchBuffer(uint64_t gfxAddress, bool overrideRingHead) {
+    ScopedOperationTimer timer(OperationType::submitBatchBuffer);
     std::vector<uint32_t> ringCommands;
 
     csTraits.addBatchBufferJump(ringCommands, gfxAddress);
@@ -361,6 +359,7 @@ void HardwareContextImp::submitBatchBuffer(uint64_t gfxAddress, bool overrideRin
 }
 
 void HardwareContextImp::writeMemory2(AllocationParams allocationParams) {
+    ScopedOperationTimer timer(OperationType::writeMemory2, allocationParams.size);
     allocationParams.pageSize = csTraits.getSupportedPageSize(allocationParams.memoryBanks, allocationParams.pageSize);
     stream.writeMemory(&ppgtt, allocationParams);
 }
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace aub_stream {
+
+namespace xxhash {
+constexpr uint32_t prime32_1 = 0x9E3779B1u;
+constexpr uint32_t prime32_2 = 0x85EBCA77u;
+constexpr uint32_t prime32_3 = 0xC2B2AE3Du;
+constexpr uint32_t prime32_4 = 0x27D4EB2Fu;
+constexpr uint32_t prime32_5 = 0x165667B1u;
+
+constexpr uint32_t rotl32(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+inline uint32_t read32(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+constexpr uint32_t round32(uint32_t acc, uint32_t input) {
+    return rotl32(acc + input * prime32_2, 13) * prime32_1;
+}
+
+constexpr uint64_t prime64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t prime64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t prime64_3 = 0x165667B19E3779F9ull;
+constexpr uint64_t prime64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t prime64_5 = 0x27D4EB2F165667C5ull;
+
+constexpr uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const uint8_t *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+constexpr uint64_t round64(uint64_t acc, uint64_t input) {
+    return rotl64(acc + input * prime64_2, 31) * prime64_1;
+}
+
+constexpr uint64_t mergeRound64(uint64_t acc, uint64_t value) {
+    return (acc ^ round64(0, value)) * prime64_1 + prime64_4;
+}
+} // namespace xxhash
+
+// XXH32 as specified by the xxHash project, needed wherever a standard checksum is expected (e.g. LZ4 frame headers)
+inline uint32_t xxHash32(const void *data, size_t size, uint32_t seed = 0) {
+    using namespace xxhash;
+    auto p = static_cast<const uint8_t *>(data);
+    auto end = p + size;
+    uint32_t hash;
+
+    if (size >= 16) {
+        uint32_t v1 = seed + prime32_1 + prime32_2;
+        uint32_t v2 = seed + prime32_2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - prime32_1;
+        for (; p + 16 <= end; p += 16) {
+            v1 = round32(v1, read32(p));
+            v2 = round32(v2, read32(p + 4));
+            v3 = round32(v3, read32(p + 8));
+            v4 = round32(v4, read32(p + 12));
+        }
+        hash = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+    } else {
+        hash = seed + prime32_5;
+    }
+    hash += static_cast<uint32_t>(size);
+
+    for (; p + 4 <= end; p += 4) {
+        hash = rotl32(hash + read32(p) * prime32_3, 17) * prime32_4;
+    }
+    for (; p < end; ++p) {
+        hash = rotl32(hash + (*p) * prime32_5, 11) * prime32_1;
+    }
+
+    hash ^= hash >> 15;
+    hash *= prime32_2;
+    hash ^= hash >> 13;
+    hash *= prime32_3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// XXH64 as specified by the xxHash project, used where a 64-bit content fingerprint is needed (e.g. page deduplication)
+inline uint64_t xxHash64(const void *data, size_t size, uint64_t seed = 0) {
+    using namespace xxhash;
+    auto p = static_cast<const uint8_t *>(data);
+    auto end = p + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + prime64_1 + prime64_2;
+        uint64_t v2 = seed + prime64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - prime64_1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+        }
+        hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        hash = mergeRound64(hash, v1);
+        hash = mergeRound64(hash, v2);
+        hash = mergeRound64(hash, v3);
+        hash = mergeRound64(hash, v4);
+    } else {
+        hash = seed + prime64_5;
+    }
+    hash += static_cast<uint64_t>(size);
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= round64(0, read64(p));
+        hash = rotl64(hash, 27) * prime64_1 + prime64_4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(p)) * prime64_1;
+        hash = rotl64(hash, 23) * prime64_2 + prime64_3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= (*p) * prime64_5;
+        hash = rotl64(hash, 11) * prime64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime64_2;
+    hash ^= hash >> 29;
+    hash *= prime64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace aub_stream
@@ -8,7 +8,22 @@
 DECLARE_SETTING_VARIABLE(bool, PrintSettings, false, "Print all settings to stdout")
 DECLARE_SETTING_VARIABLE(int, ExeclistSubmitPortSubmission, -1, "Enable submission via ELSP")
 DECLARE_SETTING_VARIABLE(int, TbxConnectionDelayInSeconds, -1, "-1: default. >=0: seconds to wait before initializing TBX connection")
+DECLARE_SETTING_VARIABLE(int, TbxSendBufferSizeKB, 0, "0: default - every TBX message is sent immediately. >0: size in KB of buffer batching MMIO, GTT, PCICFG and memory writes, sent before any request expecting a response")
+DECLARE_SETTING_VARIABLE(int, TbxPollSpinCount, 16, "Number of back-to-back reads done by TBX register and memory polls before yielding the CPU between reads")
+DECLARE_SETTING_VARIABLE(int, TbxPollYieldCount, 64, "Number of TBX poll reads separated by a thread yield before sleeping between reads")
+DECLARE_SETTING_VARIABLE(int, TbxPollMaxSleepMicroseconds, 1000, "Upper bound of the exponentially growing sleep between TBX poll reads")
+DECLARE_SETTING_VARIABLE(int, TbxPollTimeoutMilliseconds, 0, "0: default - TBX polls wait until the condition is met. >0: poll timeout, timed out polls with abort timeout action throw")
+DECLARE_SETTING_VARIABLE(bool, EnableOperationMetrics, false, "Record call counts, bytes and latency histograms of memory writes, submissions, polls, page table walks, file writes and socket round-trips, queried with AubManager::getOperationMetrics()")
+DECLARE_SETTING_VARIABLE(std::string, OperationMetricsDumpFile, "", "Empty: default - metrics not dumped. Otherwise: enables operation metrics and writes them as JSON to this file on AubManager::close()")
 DECLARE_SETTING_VARIABLE(int, LogLevel, 0, "Bitfield. 0: default - logs not printed. >=0: print logs of specific level")
 DECLARE_SETTING_VARIABLE(int, IndirectRingState, -1, "Enable indirect ring state")
 DECLARE_SETTING_VARIABLE(bool, EnablePs64, true, "Enable set the PS64 bit for 16 consecutive 4KB pages")
+DECLARE_SETTING_VARIABLE(int, PageTableWalkThreads, -1, "-1: default - up to 4 threads. 0 or 1: single thread. >1: number of threads walking memory ranges of at least 1GB whose page tables already exist")
 DECLARE_SETTING_VARIABLE(bool, AppTransientForUncompressedCachedPages, false, "Enables the App-Transient PAT attribute for uncompressed cached pages.")
+DECLARE_SETTING_VARIABLE(int, AubFileBufferSizeKB, 0, "0: default - flush AUB file after every record. >0: size in KB of user-space buffer coalescing AUB records, flushed when full, on poll/expect records, sync and close")
+DECLARE_SETTING_VARIABLE(int, AubFileAsyncWriterQueueDepth, 0, "0: default - AUB file written on the caller thread. >0: number of AubFileBufferSizeKB sized chunks queued to a dedicated writer thread")
+DECLARE_SETTING_VARIABLE(bool, AubFileVectoredWrites, false, "Gather memory write record headers, payloads and padding into a single writev() call instead of copying payloads through the file stream")
+DECLARE_SETTING_VARIABLE(bool, AubFileCompression, false, "Write AUB file as independently decodable LZ4 frames of AubFileBufferSizeKB (1MB when not set) followed by a frame index")
+DECLARE_SETTING_VARIABLE(int, AubFileCompressionThreads, -1, "-1: default - up to 4 threads. >0: number of threads compressing AUB file frames")
+DECLARE_SETTING_VARIABLE(bool, AubFileElideRepeatedPages, false, "Write 4KB pages filled with a single repeated dword (e.g. zeroed pages) as repeat memory write records holding one dword instead of the page contents")
+DECLARE_SETTING_VARIABLE(int, AubFilePageCacheEntries, 0, "0: default - disabled. >0: number of 4KB physical pages whose content hash is tracked, pages rewritten with unchanged content are not written to AUB file again. Only valid when the GPU does not modify uploaded pages between uploads")
@@ -6,9 +6,9 @@
  */
 
 #pragma once
+#include <array>
 #include <cassert>
 #include <cstdint>
-#include <vector>
 
 namespace aub_stream {
 
@@ -19,18 +19,17 @@ class MemoryBankHelper {
     const size_t size = 0;
     size_t colorSize = 1;
     uint32_t numberOfBanks = 0;
-    std::vector<uint32_t> singleBanks;
+    std::array<uint32_t, 32> singleBanks = {}; // fixed size, a helper is created by every page table walk
 
     MemoryBankHelper(uint32_t memoryBanksIn, uint64_t initialGfxAddress, size_t size) : memoryBanks(memoryBanksIn), initialGfxAddress(initialGfxAddress), size(size) {
         uint32_t mask = 1;
         do {
             if (mask & memoryBanks) {
-                singleBanks.push_back(mask);
+                singleBanks[numberOfBanks++] = mask;
             }
             mask <<= 1;
-        } while (mask <= memoryBanks);
+        } while (mask && mask <= memoryBanks);
 
-        numberOfBanks = uint32_t(singleBanks.size());
         // split memory evenly to banks
         if (numberOfBanks > 0) {
             colorSize = size / numberOfBanks;
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "aub_mem_dump/metrics_registry.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace aub_stream {
+
+MetricsRegistry &MetricsRegistry::get() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+uint32_t MetricsRegistry::getHistogramBucket(uint64_t nanoseconds) {
+    uint32_t bucket = 0;
+    while (nanoseconds > 1 && bucket < OperationMetrics::histogramBucketCount - 1) {
+        nanoseconds >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+const char *MetricsRegistry::getOperationName(OperationType operation) {
+    switch (operation) {
+    case OperationType::writeMemory2:
+        return "writeMemory2";
+    case OperationType::submitBatchBuffer:
+        return "submitBatchBuffer";
+    case OperationType::pollForCompletion:
+        return "pollForCompletion";
+    case OperationType::pageTableWalk:
+        return "pageTableWalk";
+    case OperationType::fileWrite:
+        return "fileWrite";
+    case OperationType::socketRoundTrip:
+        return "socketRoundTrip";
+    default:
+        return "unknown";
+    }
+}
+
+void MetricsRegistry::record(OperationType operation, uint64_t bytes, uint64_t nanoseconds) {
+    auto &counter = counters[static_cast<uint32_t>(operation)];
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    counter.totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    counter.latencyHistogram[getHistogramBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    auto currentMax = counter.maxNanoseconds.load(std::memory_order_relaxed);
+    while (nanoseconds > currentMax && !counter.maxNanoseconds.compare_exchange_weak(currentMax, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void MetricsRegistry::reset() {
+    for (auto &counter : counters) {
+        counter.count.store(0, std::memory_order_relaxed);
+        counter.bytes.store(0, std::memory_order_relaxed);
+        counter.totalNanoseconds.store(0, std::memory_order_relaxed);
+        counter.maxNanoseconds.store(0, std::memory_order_relaxed);
+        for (auto &bucket : counter.latencyHistogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::vector<OperationMetrics> MetricsRegistry::getOperationMetrics() const {
+    std::vector<OperationMetrics> metrics(static_cast<uint32_t>(OperationType::count));
+    for (uint32_t i = 0; i < metrics.size(); i++) {
+        auto &counter = counters[i];
+        auto &entry = metrics[i];
+        entry.name = getOperationName(static_cast<OperationType>(i));
+        entry.count = counter.count.load(std::memory_order_relaxed);
+        entry.bytes = counter.bytes.load(std::memory_order_relaxed);
+        entry.totalNanoseconds = counter.totalNanoseconds.load(std::memory_order_relaxed);
+        entry.maxNanoseconds = counter.maxNanoseconds.load(std::memory_order_relaxed);
+        for (uint32_t bucket = 0; bucket < OperationMetrics::histogramBucketCount; bucket++) {
+            entry.latencyHistogram[bucket] = counter.latencyHistogram[bucket].load(std::memory_order_relaxed);
+        }
+    }
+    return metrics;
+}
+
+std::string MetricsRegistry::toJson() const {
+    std::ostringstream json;
+    json << "{\n  \"operations\": [";
+    const char *separator = "\n";
+    for (auto &entry : getOperationMetrics()) {
+        json << separator
+             << "    {\"name\": \"" << entry.name << "\""
+             << ", \"count\": " << entry.count
+             << ", \"bytes\": " << entry.bytes
+             << ", \"totalNanoseconds\": " << entry.totalNanoseconds
+             << ", \"maxNanoseconds\": " << entry.maxNanoseconds
+             << ", \"latencyHistogram\": [";
+        for (uint32_t bucket = 0; bucket < OperationMetrics::histogramBucketCount; bucket++) {
+            json << (bucket ? ", " : "") << entry.latencyHistogram[bucket];
+        }
+        json << "]}";
+        separator = ",\n";
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
+
+bool MetricsRegistry::dumpToFile(const std::string &fileName) const {
+    std::ofstream file(fileName, std::ofstream::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << toJson();
+    return file.good();
+}
+
+} // namespace aub_stream
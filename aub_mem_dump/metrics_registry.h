@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "aubstream/operation_metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace aub_stream {
+
+enum class OperationType : uint32_t {
+    writeMemory2,
+    submitBatchBuffer,
+    pollForCompletion,
+    pageTableWalk,
+    fileWrite,
+    socketRoundTrip,
+    count
+};
+
+// Process-wide call counters, byte counts and latency histograms shared by all AubManager instances.
+// Counters are relaxed atomics; while the registry is disabled operations are not timed at all.
+class MetricsRegistry {
+  public:
+    static MetricsRegistry &get();
+
+    void enable(bool enabled) { this->enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void record(OperationType operation, uint64_t bytes, uint64_t nanoseconds);
+    void reset();
+
+    std::vector<OperationMetrics> getOperationMetrics() const;
+    std::string toJson() const;
+    bool dumpToFile(const std::string &fileName) const;
+
+    static uint32_t getHistogramBucket(uint64_t nanoseconds);
+    static const char *getOperationName(OperationType operation);
+
+  protected:
+    struct Counters {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> totalNanoseconds{0};
+        std::atomic<uint64_t> maxNanoseconds{0};
+        std::atomic<uint64_t> latencyHistogram[OperationMetrics::histogramBucketCount] = {};
+    };
+
+    std::atomic<bool> enabled{false};
+    Counters counters[static_cast<uint32_t>(OperationType::count)];
+};
+
+// Times the enclosing scope and records it in the registry when metrics are enabled.
+class ScopedOperationTimer {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    ScopedOperationTimer(OperationType operation, uint64_t bytes = 0) : operation(operation), bytes(bytes), active(MetricsRegistry::get().isEnabled()) {
+        if (active) {
+            start = Clock::now();
+        }
+    }
+
+    ~ScopedOperationTimer() {
+        if (active) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            MetricsRegistry::get().record(operation, bytes, static_cast<uint64_t>(elapsed));
+        }
+    }
+
+    ScopedOperationTimer(const ScopedOperationTimer &) = delete;
+    ScopedOperationTimer &operator=(const ScopedOperationTimer &) = delete;
+
+    void setBytes(uint64_t bytes) { this->bytes = bytes; }
+
+  protected:
+    OperationType operation;
+    uint64_t bytes;
+    bool active;
+    Clock::time_point start{};
+};
+
+} // namespace aub_stream
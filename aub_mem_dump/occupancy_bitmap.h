@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aub_stream {
+
+// Marks which entries of a page table are present, 64 entries per word, with a running population count.
+// Emptiness checks are O(1) and searches for present entries skip 64 absent entries per step.
+class OccupancyBitmap {
+  public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    OccupancyBitmap() = default;
+    explicit OccupancyBitmap(size_t entryCount) : words(getWordCount(entryCount)) {}
+
+    void resize(size_t entryCount) {
+        assert(getWordCount(entryCount) >= words.size() && "Occupancy bitmap can only grow");
+        words.resize(getWordCount(entryCount));
+    }
+
+    bool test(size_t index) const {
+        return (words[index / 64] & getBit(index)) != 0;
+    }
+
+    void set(size_t index) {
+        auto &word = words[index / 64];
+        presentCount += (word & getBit(index)) ? 0 : 1;
+        word |= getBit(index);
+    }
+
+    void reset(size_t index) {
+        auto &word = words[index / 64];
+        presentCount -= (word & getBit(index)) ? 1 : 0;
+        word &= ~getBit(index);
+    }
+
+    size_t count() const { return presentCount; }
+    bool none() const { return presentCount == 0; }
+    size_t size() const { return words.size() * 64; }
+
+    // Returns the first present entry at or after index, npos if there is none
+    size_t findNext(size_t index) const {
+        size_t wordIndex = index / 64;
+        if (wordIndex >= words.size()) {
+            return npos;
+        }
+        auto word = words[wordIndex] & (~uint64_t(0) << (index % 64));
+        while (word == 0) {
+            if (++wordIndex == words.size()) {
+                return npos;
+            }
+            word = words[wordIndex];
+        }
+        return wordIndex * 64 + std::countr_zero(word);
+    }
+
+    // Returns the number of present entries in [first, last)
+    size_t countInRange(size_t first, size_t last) const {
+        size_t result = 0;
+        while (first < last) {
+            auto bitsInWord = std::min<size_t>(64 - first % 64, last - first);
+            auto mask = (bitsInWord == 64 ? ~uint64_t(0) : (getBit(bitsInWord) - 1)) << (first % 64);
+            result += std::popcount(words[first / 64] & mask);
+            first += bitsInWord;
+        }
+        return result;
+    }
+
+  protected:
+    static size_t getWordCount(size_t entryCount) { return (entryCount + 63) / 64; }
+    static uint64_t getBit(size_t index) { return uint64_t(1) << (index % 64); }
+
+    std::vector<uint64_t> words;
+    uint32_t presentCount = 0;
+};
+
+} // namespace aub_stream
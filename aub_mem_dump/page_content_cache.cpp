@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "page_content_cache.h"
+
+#include <cassert>
+
+namespace aub_stream {
+
+PageContentCache::PageContentCache(size_t entryCount) {
+    // power of two so the slot is the top bits of a multiplicative hash
+    size_t slotCount = 2;
+    slotShift = 63;
+    while (slotCount < entryCount) {
+        slotCount <<= 1;
+        slotShift--;
+    }
+    entries.resize(slotCount);
+}
+
+PageContentCache::Entry &PageContentCache::getEntry(uint64_t tag) {
+    // Fibonacci hashing spreads sequential page addresses over the whole table
+    return entries[(tag * 0x9E3779B97F4A7C15ull) >> slotShift];
+}
+
+bool PageContentCache::update(uint64_t pageAddress, int addressSpace, uint64_t contentHash) {
+    assert((pageAddress & (pageSize - 1)) == 0);
+    auto tag = makeTag(pageAddress, addressSpace);
+    auto &entry = getEntry(tag);
+    if (entry.tag == tag && entry.contentHash == contentHash) {
+        return true;
+    }
+    entry.tag = tag;
+    entry.contentHash = contentHash;
+    return false;
+}
+
+void PageContentCache::invalidate(uint64_t physicalAddress, size_t size, int addressSpace) {
+    if (size == 0) {
+        return;
+    }
+    auto firstPage = physicalAddress & ~(pageSize - 1);
+    auto lastPage = (physicalAddress + size - 1) & ~(pageSize - 1);
+    for (auto pageAddress = firstPage; pageAddress <= lastPage; pageAddress += pageSize) {
+        auto tag = makeTag(pageAddress, addressSpace);
+        auto &entry = getEntry(tag);
+        if (entry.tag == tag) {
+            entry = {};
+        }
+    }
+}
+
+} // namespace aub_stream
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aub_stream {
+
+// Remembers a 64-bit content hash of the last write to each 4KB physical page so unchanged re-uploads can be skipped.
+// The cache is direct mapped with a fixed number of slots: a page landing in an occupied slot evicts the previous
+// one, which only costs a redundant write later. Memory use is bounded by the slot count given at construction.
+struct PageContentCache {
+    static constexpr uint64_t pageSize = 4096;
+
+    explicit PageContentCache(size_t entryCount);
+
+    // returns true when the page already holds content with this hash, otherwise records the hash
+    bool update(uint64_t pageAddress, int addressSpace, uint64_t contentHash);
+    // forgets every page overlapping the range, used for partial page writes
+    void invalidate(uint64_t physicalAddress, size_t size, int addressSpace);
+
+    void addBytesSaved(uint64_t size) { bytesSaved += size; }
+    uint64_t getBytesSaved() const { return bytesSaved; }
+    size_t getEntryCount() const { return entries.size(); }
+
+  protected:
+    struct Entry {
+        uint64_t tag = 0; // page address | address space | valid bit, zero marks an empty slot
+        uint64_t contentHash = 0;
+    };
+
+    static uint64_t makeTag(uint64_t pageAddress, int addressSpace) {
+        return pageAddress | (static_cast<uint64_t>(addressSpace & 0xF) << 1) | 1;
+    }
+    Entry &getEntry(uint64_t tag);
+
+    std::vector<Entry> entries;
+    uint32_t slotShift = 63;
+    uint64_t bytesSaved = 0;
+};
+
+} // namespace aub_stream
@@ -6,6 +6,7 @@
  */
 
 #include "gpu.h"
+#include "memory_banks.h"
 #include "page_table.h"
 #include <algorithm>
 #include <cassert>
@@ -17,6 +18,10 @@ PageTable::PageTable(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAl
       allocator(physicalAddressAllocator),
       physicalAddress(0u),
       memoryBank(memoryBank) {
+    if (tableCount <= maxFixedTableCount) {
+        table.resize(tableCount);
+        occupancy.resize(tableCount);
+    }
     // Allocate dedicate memory for table if requested
     if (size) {
         size = std::max(size, size_t(4096));
@@ -40,17 +45,152 @@ uint64_t Page2MB::getEntryValue() const {
     return getPhysicalAddress() | bits;
 }
 
+PageTableLeaf::PageTableLeaf(uint64_t physicalAddress, uint32_t memoryBank, const AllocationParams::AdditionalParams &additionalAllocParams, bool ownsPhysicalMemory) {
+    setPhysicalAddress(physicalAddress);
+    setMemoryBank(memoryBank);
+    setBit(presentBit, true);
+    setBit(ownsPhysicalMemoryBit, ownsPhysicalMemory);
+    setBit(compressionEnabledBit, additionalAllocParams.compressionEnabled);
+    setBit(uncachedBit, additionalAllocParams.uncached);
+}
+
+void PageTableLeaf::setMemoryBank(uint32_t memoryBank) {
+    assert(0 == (memoryBank & (memoryBank - 1)) && "Leaf page must be in a single memory bank");
+    uint64_t bankBits = 0;
+    if (memoryBank) {
+        bankBits = toBitValue(localMemoryBit) | (static_cast<uint64_t>(toMemoryBankId(static_cast<MemoryBank>(memoryBank))) << memoryBankIdShift);
+    }
+    packed = (packed & (toBitValue(memoryBankIdShift) - 1) & ~toBitValue(localMemoryBit)) | bankBits;
+}
+
+// Same bits a leaf PageTable reports from PageTable::getEntryValue
+uint64_t PageTableLeaf::getEntryValue(const Gpu &gpu) const {
+    auto bits = toBitValue(PpgttEntryBits::writableBit, PpgttEntryBits::presentBit);
+    bits |= isLocalMemory() ? toBitValue(PpgttEntryBits::localMemoryBit) : 0;
+    bits |= isPs64() ? toBitValue(PpgttEntryBits::ps64Bit) : 0;
+    bits |= gpu.getPPGTTExtraEntryBits(peekAllocationParams());
+    return getPhysicalAddress() | bits;
+}
+
 PageTable::~PageTable() {
     if (allocator) {
         allocator->freePhysicalMemory(memoryBank, physicalAddress);
     }
-    for (auto &entry : table) {
-        delete entry;
+    if (ownedArena) {
+        // Root table: release the whole tree slab by slab rather than node by node
+        ownedArena->releaseAll();
+    } else if (arena && !arena->isReleasing()) {
+        for (auto index = occupancy.findNext(0); index != OccupancyBitmap::npos; index = occupancy.findNext(index + 1)) {
+            arena->destroy(table[index]);
+        }
+    }
+}
+
+PTE::~PTE() {
+    if (allocator) {
+        // Release the table before its pages, the order ~PageTable used for leaf children
+        allocator->freePhysicalMemory(memoryBank, physicalAddress);
+        for (auto index = findNextLeaf(0); index != OccupancyBitmap::npos; index = findNextLeaf(static_cast<unsigned int>(index + 1))) {
+            freeLeafMemory(leaves[index]);
+        }
+        allocator = nullptr;
+    }
+}
+
+PageTableLeaf *PTE::allocateLeaf(unsigned int index, uint32_t pageMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams) {
+    assert(index < leafCount && !leaves[index].isPresent());
+    auto pageSize = getPageSize();
+    auto pagePhysicalAddress = allocator->reservePhysicalMemory(pageMemoryBank, pageSize, pageSize);
+    leaves[index] = PageTableLeaf(pagePhysicalAddress, pageMemoryBank, additionalAllocParams, true);
+    occupancy.set(index);
+    updatePs64Group(index);
+    return &leaves[index];
+}
+
+PageTableLeaf *PTE::setLeaf(unsigned int index, uint64_t physicalAddress, uint32_t pageMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams) {
+    assert(index < leafCount && !leaves[index].isPresent());
+    leaves[index] = PageTableLeaf(physicalAddress, pageMemoryBank, additionalAllocParams, false);
+    occupancy.set(index);
+    updatePs64Group(index);
+    return &leaves[index];
+}
+
+void PTE::releaseLeaf(unsigned int index) {
+    assert(index < leafCount);
+    freeLeafMemory(leaves[index]);
+    leaves[index] = {};
+    occupancy.reset(index);
+    updatePs64Group(index);
+}
+
+void PTE::trackPs64Groups() {
+    if (ps64Groups) {
+        return;
+    }
+    ps64Groups = std::make_unique<Ps64Groups>();
+    for (unsigned int groupBase = 0; groupBase < leafCount; groupBase += ps64GroupSize) {
+        updatePs64Group(groupBase);
+    }
+}
+
+void PTE::updatePs64Group(unsigned int index) {
+    if (!ps64Groups) {
+        return;
+    }
+    const auto group = index / ps64GroupSize;
+    const auto groupBase = group * ps64GroupSize;
+    auto &matchingSlots = ps64Groups->matchingSlots[group];
+    auto &firstSlotFlags = ps64Groups->firstSlotFlags[group];
+    if (index == groupBase) {
+        // Every other slot is matched against slot 0, so a change there rechecks the whole group
+        const auto &first = leaves[groupBase];
+        matchingSlots = 0;
+        if (first.isPresent() && (first.getPhysicalAddress() & 0xffff) == 0) {
+            firstSlotFlags = getPs64EntryFlags(first);
+            for (unsigned int slot = 0; slot < ps64GroupSize; slot++) {
+                matchingSlots |= continuesPs64Group(groupBase, slot, firstSlotFlags) ? (1u << slot) : 0u;
+            }
+        }
+    } else if (matchingSlots & 1u) {
+        const auto slot = index - groupBase;
+        matchingSlots = continuesPs64Group(groupBase, slot, firstSlotFlags) ? (matchingSlots | (1u << slot)) : (matchingSlots & ~(1u << slot));
+    }
+
+    const uint32_t groupBit = 1u << group;
+    ps64Groups->complete = matchingSlots == 0xffff ? (ps64Groups->complete | groupBit) : (ps64Groups->complete & ~groupBit);
+}
+
+bool PTE::markLeafEmitted(unsigned int index, uint64_t walkEpoch) {
+    assert(ps64Groups && index < leafCount);
+    if (ps64Groups->emittedEpoch != walkEpoch) {
+        ps64Groups->emittedEpoch = walkEpoch;
+        ps64Groups->emittedLeaves.fill(0);
+    }
+    auto &word = ps64Groups->emittedLeaves[index / 64];
+    const uint64_t bit = 1ull << (index % 64);
+    if (word & bit) {
+        return false;
+    }
+    word |= bit;
+    return true;
+}
+
+// Slot 0 must be present and 64KB aligned, checked by the caller
+bool PTE::continuesPs64Group(unsigned int groupBase, unsigned int slot, uint64_t firstSlotFlags) const {
+    const auto &leaf = leaves[groupBase + slot];
+    return leaf.isPresent() &&
+           leaf.getPhysicalAddress() == leaves[groupBase].getPhysicalAddress() + slot * 4096 &&
+           getPs64EntryFlags(leaf) == firstSlotFlags;
+}
+
+void PTE::freeLeafMemory(const PageTableLeaf &leaf) {
+    if (leaf.ownsPhysicalMemory()) {
+        allocator->freePhysicalMemory(leaf.getMemoryBank(), leaf.getPhysicalAddress());
     }
 }
 
 GGTT::GGTT(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank, uint64_t gttBaseAddress)
-    : PageTable(gpu, physicalAddressAllocator, 0u, 1u << 20, memoryBank),
+    : PageTable(gpu, physicalAddressAllocator, 0u, 0u, memoryBank),
       entryOffset(0),
       gfxAddressAllocator(0u),
       gttTableOffset(gttBaseAddress) {
@@ -65,4 +205,28 @@ GGTT::GGTT(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, u
     }
 }
 
+GGTT::~GGTT() {
+    for (auto pagePhysicalAddress : ownedPages) {
+        allocator->freePhysicalMemory(memoryBank, pagePhysicalAddress);
+    }
+}
+
+const uint64_t *GGTT::mapPage(unsigned int index, size_t pageSize, bool isLocalMemory) {
+    const auto entryCount = static_cast<unsigned int>(pageSize / 4096);
+    if (entries.size() < index + entryCount) {
+        // Commit whole 4KB chunks of entries, GGTT addresses are handed out from the bottom up
+        entries.resize((static_cast<size_t>(index) + entryCount + 511) & ~static_cast<size_t>(511));
+    }
+
+    const auto pagePhysicalAddress = allocator->reservePhysicalMemory(memoryBank, pageSize, pageSize);
+    ownedPages.push_back(pagePhysicalAddress);
+
+    const auto enableBits = isLocalMemory ? toBitValue(validBit, localMemoryBit)
+                                          : toBitValue(validBit);
+    for (auto i = 0u; i < entryCount; i++) {
+        entries[index + i] = (pagePhysicalAddress + i * 4096) | enableBits;
+    }
+    return &entries[index];
+}
+
 } // namespace aub_stream
@@ -7,12 +7,17 @@
 
 #pragma once
 #include "physical_address_allocator.h"
+#include "occupancy_bitmap.h"
+#include "page_table_arena.h"
 #include "page_table_entry_bits.h"
+#include "translation_cache.h"
 #include "aubstream/allocation_params.h"
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 #include <mutex>
 namespace aub_stream {
@@ -28,6 +33,8 @@ constexpr int Pml5 = 4;
 struct Gpu;
 
 struct PageTable {
+    // Tables up to this many entries get a fixed child array at construction, larger ones grow on demand
+    static constexpr unsigned int maxFixedTableCount = 512u;
 
     PageTable(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, size_t size, unsigned int tableCount, uint32_t memoryBank);
 
@@ -74,10 +81,21 @@ struct PageTable {
     void setChild(unsigned int index, PageTable *child) {
         if (table.size() <= index) {
             table.resize(index + 1);
+            occupancy.resize(index + 1);
+        }
+        if (child) {
+            occupancy.set(index);
+        } else {
+            occupancy.reset(index);
         }
         table[index] = child;
     }
 
+    // Returns the index of the first child at or after index, OccupancyBitmap::npos if there is none
+    size_t findNextChild(unsigned int index) const {
+        return occupancy.findNext(index);
+    }
+
     bool isLocalMemory() const {
         return memoryBank != 0;
     }
@@ -120,13 +138,8 @@ struct PageTable {
         return additionalAllocParams;
     }
 
-    bool isEmpty() const {
-        for (const auto &entry : table) {
-            if (entry != nullptr) {
-                return false;
-            }
-        }
-        return true;
+    virtual bool isEmpty() const {
+        return occupancy.none();
     }
 
     // Returns page size for leaf nodes (PTE, Page2MB), 0 for non-leaf nodes
@@ -140,13 +153,52 @@ struct PageTable {
     void setPendingWrite(bool enable) { pendingWrite = enable; }
     bool isPendingWrite() const { return pendingWrite; }
 
+    // Returns true the first time the walk with walkEpoch reaches this table, so shared interior tables are emitted once
+    bool markEmitted(uint64_t walkEpoch) {
+        if (emittedEpoch == walkEpoch) {
+            return false;
+        }
+        emittedEpoch = walkEpoch;
+        return true;
+    }
+
+    // Arena holding the nodes below this table's root, created by the first child of a root table
+    PageTableArena &getArena() {
+        if (!arena) {
+            ownedArena = std::make_unique<PageTableArena>();
+            arena = ownedArena.get();
+        }
+        return *arena;
+    }
+
+    // Translations of the root table, filled by expect walks and invalidated by walks and frees that change mappings
+    TranslationCache &getTranslationCache() {
+        if (!translationCache) {
+            translationCache = std::make_unique<TranslationCache>();
+        }
+        return *translationCache;
+    }
+
+    void invalidateTranslations(uint64_t gfxAddress, size_t size) {
+        if (translationCache) {
+            translationCache->invalidate(gfxAddress, size);
+        }
+    }
+
   protected:
+    friend class PageTableArena;
+
     const Gpu &gpu;
     PhysicalAddressAllocator *allocator;
     AllocationParams::AdditionalParams additionalAllocParams = {};
     uint64_t physicalAddress;
     uint32_t memoryBank = 0;
     std::vector<PageTable *> table;
+    OccupancyBitmap occupancy;
+    PageTableArena *arena = nullptr;
+    std::unique_ptr<PageTableArena> ownedArena;
+    std::unique_ptr<TranslationCache> translationCache;
+    uint64_t emittedEpoch = 0;
     bool ps64 = false;
     bool pendingWrite = false;
 
@@ -157,33 +209,162 @@ struct PageTable {
 
 using PageTableMemory = PageTable;
 
-template <typename PageTableMemoryType>
-struct PTEBase : public PageTable {
-    PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank) override {
-        return new PageTableMemoryType(gpu, allocator, pageSize, 0u, pageTableMemoryBank);
+// Leaf entry of a PTE, packed into 64 bits: the physical address in bits 0-51 and the page state in bits 52-63.
+// PTEs keep their pages as a dense array of these instead of one PageTable object per page.
+struct PageTableLeaf {
+    static constexpr uint64_t physicalAddressMask = (1ull << 52) - 1;
+    static constexpr uint32_t presentBit = 52;
+    static constexpr uint32_t ownsPhysicalMemoryBit = 53;
+    static constexpr uint32_t ps64Bit = 54;
+    static constexpr uint32_t pendingWriteBit = 55;
+    static constexpr uint32_t compressionEnabledBit = 56;
+    static constexpr uint32_t uncachedBit = 57;
+    static constexpr uint32_t localMemoryBit = 58;
+    static constexpr uint32_t memoryBankIdShift = 59;
+
+    PageTableLeaf() = default;
+    PageTableLeaf(uint64_t physicalAddress, uint32_t memoryBank, const AllocationParams::AdditionalParams &additionalAllocParams, bool ownsPhysicalMemory);
+
+    bool isPresent() const { return isBitSet(presentBit); }
+    bool ownsPhysicalMemory() const { return isBitSet(ownsPhysicalMemoryBit); }
+
+    uint64_t getPhysicalAddress() const {
+        return packed & physicalAddressMask;
     }
 
-    PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams) override {
-        return new PageTableMemoryType(gpu, allocator, pageSize, 0u, pageTableMemoryBank, additionalAllocParams);
+    void setPhysicalAddress(uint64_t physicalAddress) {
+        assert((physicalAddress & ~physicalAddressMask) == 0);
+        packed = (packed & ~physicalAddressMask) | physicalAddress;
     }
 
-    // Allocate child at pre-reserved physical address
-    PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams, uint64_t physicalAddress) override {
-        return new PageTableMemoryType(gpu, physicalAddress, pageTableMemoryBank, additionalAllocParams);
+    bool isLocalMemory() const { return isBitSet(localMemoryBit); }
+
+    uint32_t getMemoryBank() const {
+        return isLocalMemory() ? 1u << static_cast<uint32_t>(packed >> memoryBankIdShift) : 0u;
     }
 
-    PTEBase(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank)
-        : PageTable(gpu, physicalAddressAllocator, 4096u, 512u, memoryBank) {
+    // Leaf pages live in system memory or a single memory bank
+    void setMemoryBank(uint32_t memoryBank);
+
+    AllocationParams::AdditionalParams peekAllocationParams() const {
+        AllocationParams::AdditionalParams additionalAllocParams = {};
+        additionalAllocParams.compressionEnabled = isBitSet(compressionEnabledBit);
+        additionalAllocParams.uncached = isBitSet(uncachedBit);
+        return additionalAllocParams;
     }
 
-    PTEBase(const Gpu &gpu, uint64_t physicalAddress, uint32_t memoryBank)
-        : PageTable(gpu, physicalAddress, memoryBank) {
+    void setPs64(bool enable) { setBit(ps64Bit, enable); }
+    bool isPs64() const { return isBitSet(ps64Bit); }
+
+    void setPendingWrite(bool enable) { setBit(pendingWriteBit, enable); }
+    bool isPendingWrite() const { return isBitSet(pendingWriteBit); }
+
+    uint64_t getEntryValue(const Gpu &gpu) const;
+
+  protected:
+    bool isBitSet(uint32_t bit) const {
+        return (packed & toBitValue(bit)) != 0;
     }
 
-    size_t getPageSize() const override = 0;
+    void setBit(uint32_t bit, bool enable) {
+        packed = enable ? (packed | toBitValue(bit)) : (packed & ~toBitValue(bit));
+    }
+
+    uint64_t packed = 0;
 };
 
-using PTE = PTEBase<PageTableMemory>;
+static_assert(sizeof(PageTableLeaf) == sizeof(uint64_t), "PageTableLeaf must stay a single packed entry");
+
+struct PTE : public PageTable {
+    static constexpr unsigned int leafCount = 512u;
+
+    PTE(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank)
+        : PageTable(gpu, physicalAddressAllocator, 4096u, 0u, memoryBank),
+          leaves(leafCount) {
+        occupancy.resize(leafCount);
+    }
+
+    PTE(const Gpu &gpu, uint64_t physicalAddress, uint32_t memoryBank)
+        : PageTable(gpu, physicalAddress, memoryBank),
+          leaves(leafCount) {
+        occupancy.resize(leafCount);
+    }
+
+    ~PTE() override;
+
+    // Returns nullptr when no page is mapped at index
+    PageTableLeaf *getLeaf(unsigned int index) {
+        assert(index < leafCount);
+        return leaves[index].isPresent() ? &leaves[index] : nullptr;
+    }
+
+    // Reserves a new page from the PTE allocator, freed together with the leaf
+    PageTableLeaf *allocateLeaf(unsigned int index, uint32_t pageMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams);
+
+    // Maps a page at a physical address owned by the caller
+    PageTableLeaf *setLeaf(unsigned int index, uint64_t physicalAddress, uint32_t pageMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams);
+
+    void releaseLeaf(unsigned int index);
+
+    // Returns the index of the first mapped page at or after index, OccupancyBitmap::npos if there is none
+    size_t findNextLeaf(unsigned int index) const {
+        return occupancy.findNext(index);
+    }
+
+    // Returns the number of mapped pages with index in [first, last)
+    size_t countLeavesInRange(unsigned int first, unsigned int last) const {
+        return occupancy.countInRange(first, last);
+    }
+
+    uint64_t getLeafEntryValue(unsigned int index) const {
+        return leaves[index].getEntryValue(gpu);
+    }
+
+    // Entry bits a leaf must share with the rest of its PS64 group, everything but the address and the PS64 bit
+    uint64_t getPs64EntryFlags(const PageTableLeaf &leaf) const {
+        return (leaf.getEntryValue(gpu) ^ leaf.getPhysicalAddress()) & ~toBitValue(PpgttEntryBits::ps64Bit);
+    }
+
+    // Starts keeping PS64 group state of this table up to date, done by the first PS64 walk over it
+    void trackPs64Groups();
+
+    // Returns true when the 16 leaves of the group holding index map one 64KB-aligned physical range
+    // with identical entry flags. Only valid once trackPs64Groups was called.
+    bool isPs64GroupComplete(unsigned int index) const {
+        assert(ps64Groups);
+        return (ps64Groups->complete >> (index / ps64GroupSize)) & 1u;
+    }
+
+    // Must be called after the address or memory bank of the leaf at index is changed in place
+    void updatePs64Group(unsigned int index);
+
+    // Leaf counterpart of markEmitted, PS64 group passes may visit a leaf several times per walk.
+    // Only valid once trackPs64Groups was called.
+    bool markLeafEmitted(unsigned int index, uint64_t walkEpoch);
+
+    size_t getPageSize() const override = 0;
+
+    static constexpr unsigned int ps64GroupSize = 16u;
+
+  protected:
+    void freeLeafMemory(const PageTableLeaf &leaf);
+    bool continuesPs64Group(unsigned int groupBase, unsigned int slot, uint64_t firstSlotFlags) const;
+
+    struct Ps64Groups {
+        uint32_t complete = 0;
+        // Bit k is set when slot k of the group continues the 64KB-aligned range started by slot 0
+        std::array<uint16_t, leafCount / ps64GroupSize> matchingSlots = {};
+        // getPs64EntryFlags of slot 0, valid while bit 0 of matchingSlots is set
+        std::array<uint64_t, leafCount / ps64GroupSize> firstSlotFlags = {};
+        // Leaves marked by the walk with emittedEpoch
+        uint64_t emittedEpoch = 0;
+        std::array<uint64_t, leafCount / 64> emittedLeaves = {};
+    };
+
+    // Pages are tracked in the occupancy bitmap of the PageTable base, PTEs have no child nodes
+    std::vector<PageTableLeaf> leaves;
+    std::unique_ptr<Ps64Groups> ps64Groups;
+};
 
 struct LegacyPTE64KB : public PTE {
     LegacyPTE64KB(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank)
@@ -292,20 +473,20 @@ struct PDEBase : public PageTable {
     PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank) override {
         if (pageSize == Page2MB::pageSize2MB) {
             // Page2MB is a leaf node - can have different memory bank than parent PDE
-            return new Page2MB(gpu, allocator, pageTableMemoryBank);
+            return getArena().create<Page2MB>(gpu, allocator, pageTableMemoryBank);
         }
         assert(pageTableMemoryBank == memoryBank);
         if (pageSize == 65536u) {
-            return new ChildType64KB(gpu, allocator, pageTableMemoryBank);
+            return getArena().create<ChildType64KB>(gpu, allocator, pageTableMemoryBank);
         } else {
-            return new ChildType4KB(gpu, allocator, pageTableMemoryBank);
+            return getArena().create<ChildType4KB>(gpu, allocator, pageTableMemoryBank);
         }
     }
 
     PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams) override {
         if (pageSize == Page2MB::pageSize2MB) {
             // Page2MB is a leaf node - can have different memory bank than parent PDE
-            return new Page2MB(gpu, allocator, pageTableMemoryBank, additionalAllocParams);
+            return getArena().create<Page2MB>(gpu, allocator, pageTableMemoryBank, additionalAllocParams);
         }
         assert(pageTableMemoryBank == memoryBank);
         return allocateChild(gpu, pageSize, pageTableMemoryBank);
@@ -314,7 +495,7 @@ struct PDEBase : public PageTable {
     PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank, const AllocationParams::AdditionalParams &additionalAllocParams, uint64_t physicalAddress) override {
         if (pageSize == Page2MB::pageSize2MB) {
             // Page2MB is a leaf node - can have different memory bank than parent PDE
-            return new Page2MB(gpu, physicalAddress, pageTableMemoryBank, additionalAllocParams);
+            return getArena().create<Page2MB>(gpu, physicalAddress, pageTableMemoryBank, additionalAllocParams);
         }
         assert(pageTableMemoryBank == memoryBank);
         return allocateChild(gpu, pageSize, pageTableMemoryBank);
@@ -340,7 +521,7 @@ struct PDPBase : public PageTable {
 
     PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank) override {
         assert(pageTableMemoryBank == memoryBank);
-        return new ChildType(gpu, allocator, pageTableMemoryBank);
+        return getArena().create<ChildType>(gpu, allocator, pageTableMemoryBank);
     }
 
     PDPBase(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank)
@@ -365,7 +546,7 @@ struct PML4Base : public PageTable {
 
     PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank) override {
         assert(pageTableMemoryBank == memoryBank);
-        return new ChildType(gpu, allocator, pageTableMemoryBank);
+        return getArena().create<ChildType>(gpu, allocator, pageTableMemoryBank);
     }
 
     PML4Base(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank)
@@ -392,7 +573,7 @@ struct PDP4Base : public PageTable {
 
     PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank) override {
         assert(pageTableMemoryBank == memoryBank);
-        return new ChildType(gpu, allocator, pageTableMemoryBank);
+        return getArena().create<ChildType>(gpu, allocator, pageTableMemoryBank);
     }
 
     PDP4Base(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank)
@@ -409,24 +590,34 @@ struct PDP4Base : public PageTable {
 using PDP4 = PDP4Base<PDE>;
 using LegacyPDP4 = PDP4Base<LegacyPDE>;
 
+// The GGTT keeps the value of every entry it wrote in a flat array indexed by getIndex, committed in
+// 4KB chunks of entries as addresses are mapped, instead of one child table per 4KB page.
 struct GGTT : public PageTable {
     using AddressType = uint32_t;
+    static constexpr uint32_t validBit = 0;
+    static constexpr uint32_t localMemoryBit = 1;
+    static constexpr uint64_t physicalAddressMask = ~static_cast<uint64_t>(4095);
 
     GGTT(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank, uint64_t gttBaseAddress = 0);
+    ~GGTT() override;
 
     unsigned int getIndex(uint64_t gfxAddress) override {
         return uint32_t(gfxAddress) >> 12;
     }
 
-    PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank) override {
-        assert(pageTableMemoryBank == memoryBank);
-        return new PageTableMemory(gpu, allocator, pageSize, 0u, pageTableMemoryBank);
-    }
-
     size_t getPageSize() const override {
         return 4096u;
     }
 
+    // Returns the entry written at index, 0 when the address was never mapped
+    uint64_t getEntry(unsigned int index) const {
+        return index < entries.size() ? entries[index] : 0u;
+    }
+
+    // Reserves a page of pageSize bytes for the addresses starting at index and fills one entry per 4KB of it.
+    // Returns the first of the pageSize / 4096 entries.
+    const uint64_t *mapPage(unsigned int index, size_t pageSize, bool isLocalMemory);
+
     uint64_t entryOffset;
 
     auto getEntryOffset() const -> decltype(entryOffset) {
@@ -440,6 +631,10 @@ struct GGTT : public PageTable {
     SimpleAllocator<uint32_t> gfxAddressAllocator;
     uint64_t gttTableOffset; // An offset into either System Memory or Local Memory base
     std::mutex mutex;
+
+  protected:
+    std::vector<uint64_t> entries;
+    std::vector<uint64_t> ownedPages;
 };
 
 } // namespace aub_stream
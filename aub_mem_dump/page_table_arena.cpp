@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "page_table_arena.h"
+#include "alloc_tools.h"
+#include "page_table.h"
+#include <cassert>
+
+namespace aub_stream {
+
+PageTableArena::~PageTableArena() {
+    releaseAll();
+}
+
+void PageTableArena::destroy(PageTable *node) {
+    if (!node) {
+        return;
+    }
+    assert(node->arena == this);
+    node->~PageTable();
+    freeSlot(node);
+}
+
+void PageTableArena::releaseAll() {
+    releasing = true;
+    for (auto slab : slabs) {
+        auto header = reinterpret_cast<SlabHeader *>(slab);
+        for (size_t i = 0; i < slotsPerSlab && header->live.any(); i++) {
+            if (header->live.test(i)) {
+                header->live.reset(i);
+                static_cast<PageTable *>(getSlot(slab, i))->~PageTable();
+            }
+        }
+        header->~SlabHeader();
+        aligned_free(slab);
+    }
+    slabs.clear();
+    freeList = nullptr;
+    liveNodeCount = 0;
+    releasing = false;
+}
+
+void *PageTableArena::allocateSlot() {
+    if (!freeList) {
+        addSlab();
+    }
+    auto slot = freeList;
+    freeList = slot->next;
+
+    reinterpret_cast<SlabHeader *>(getSlab(slot))->live.set(getSlotIndex(slot));
+    liveNodeCount++;
+    return slot;
+}
+
+void PageTableArena::freeSlot(void *slot) {
+    auto header = reinterpret_cast<SlabHeader *>(getSlab(slot));
+    assert(header->live.test(getSlotIndex(slot)));
+    header->live.reset(getSlotIndex(slot));
+    liveNodeCount--;
+
+    freeList = new (slot) FreeSlot{freeList};
+}
+
+void PageTableArena::addSlab() {
+    auto slab = static_cast<uint8_t *>(aligned_alloc(slabSize, slabSize));
+    if (!slab) {
+        throw std::bad_alloc();
+    }
+    new (slab) SlabHeader();
+    slabs.push_back(slab);
+
+    // Thread slots in reverse so they are handed out in address order
+    for (size_t i = slotsPerSlab; i-- > 0;) {
+        freeList = new (getSlot(slab, i)) FreeSlot{freeList};
+    }
+}
+
+void PageTableArena::adopt(PageTable *node, void *slot) {
+    // releaseAll finds nodes by slot address, so the PageTable base must start the slot
+    assert(static_cast<void *>(node) == slot);
+    node->arena = this;
+}
+
+} // namespace aub_stream
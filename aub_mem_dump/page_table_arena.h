@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace aub_stream {
+
+struct PageTable;
+
+// Slab arena owning the page table nodes below one PPGTT root.
+// Nodes are placed in fixed-size, cache-line aligned slots of 64KB slabs and freed slots are recycled through an
+// intrusive free list, so allocate and free are O(1). Destroying the arena releases every remaining node slab by
+// slab instead of walking the tree.
+class PageTableArena {
+  public:
+    static constexpr size_t cacheLineSize = 64;
+    static constexpr size_t slotSize = 3 * cacheLineSize;
+    static constexpr size_t slabSize = 64 * 1024;
+    static constexpr size_t slotsPerSlab = slabSize / slotSize - 1; // first slot of a slab holds its header
+
+    PageTableArena() = default;
+    PageTableArena(const PageTableArena &) = delete;
+    PageTableArena &operator=(const PageTableArena &) = delete;
+    ~PageTableArena();
+
+    template <typename NodeType, typename... Args>
+    NodeType *create(Args &&...args) {
+        static_assert(sizeof(NodeType) <= slotSize, "Page table node does not fit in an arena slot");
+        static_assert(alignof(NodeType) <= cacheLineSize, "Page table node alignment exceeds arena slot alignment");
+
+        void *slot = allocateSlot();
+        NodeType *node = nullptr;
+        try {
+            node = new (slot) NodeType(std::forward<Args>(args)...);
+        } catch (...) {
+            freeSlot(slot);
+            throw;
+        }
+        adopt(node, slot);
+        return node;
+    }
+
+    // Runs the node destructor, which destroys its children, and returns its slot to the free list
+    void destroy(PageTable *node);
+
+    // Destroys every live node in slab order and frees all slabs. Node destructors don't recurse while this runs.
+    void releaseAll();
+
+    bool isReleasing() const { return releasing; }
+    size_t getLiveNodeCount() const { return liveNodeCount; }
+    size_t getSlabCount() const { return slabs.size(); }
+
+  protected:
+    struct SlabHeader {
+        std::bitset<slotsPerSlab> live;
+    };
+    static_assert(sizeof(SlabHeader) <= slotSize, "Slab header must fit in the first slot");
+
+    struct FreeSlot {
+        FreeSlot *next;
+    };
+
+    static uint8_t *getSlab(const void *slot) {
+        return reinterpret_cast<uint8_t *>(reinterpret_cast<uintptr_t>(slot) & ~static_cast<uintptr_t>(slabSize - 1));
+    }
+    static size_t getSlotIndex(const void *slot) {
+        return (static_cast<const uint8_t *>(slot) - getSlab(slot)) / slotSize - 1;
+    }
+    static void *getSlot(uint8_t *slab, size_t slotIndex) {
+        return slab + (slotIndex + 1) * slotSize;
+    }
+
+    void *allocateSlot();
+    void freeSlot(void *slot);
+    void addSlab();
+    void adopt(PageTable *node, void *slot);
+
+    std::vector<uint8_t *> slabs;
+    FreeSlot *freeList = nullptr;
+    size_t liveNodeCount = 0;
+    bool releasing = false;
+};
+
+} // namespace aub_stream
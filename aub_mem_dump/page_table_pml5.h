@@ -23,7 +23,7 @@ struct PML5 : public PageTable {
 
     PageTable *allocateChild(const Gpu &gpu, size_t pageSize, uint32_t pageTableMemoryBank) override {
         assert(pageTableMemoryBank == memoryBank);
-        return new PML4(gpu, allocator, pageTableMemoryBank);
+        return getArena().create<PML4>(gpu, allocator, pageTableMemoryBank);
     }
 
     PML5(const Gpu &gpu, PhysicalAddressAllocator *physicalAddressAllocator, uint32_t memoryBank)
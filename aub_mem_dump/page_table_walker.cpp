@@ -8,10 +8,14 @@
 #include "aub_mem_dump/page_table_walker.h"
 #include "aub_mem_dump/gpu.h"
 #include "aub_mem_dump/memory_bank_helper.h"
+#include "aub_mem_dump/metrics_registry.h"
 #include "aub_mem_dump/page_table.h"
 #include "aub_mem_dump/settings.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <unordered_set>
+#include <future>
+#include <thread>
 
 namespace aub_stream {
 
@@ -37,27 +41,287 @@ inline bool hasExistingPageTableConflict(PageTable *child, int level, size_t pag
     return false;
 }
 
-inline uint64_t ps64EntryFlags(const PageTable *entry) {
-    return (entry->getEntryValue() ^ entry->getPhysicalAddress()) & ~toBitValue(PpgttEntryBits::ps64Bit);
+using WalkMode = PageTableWalker::WalkMode;
+
+// Tables and leaves stamped with the epoch of the current walk were already emitted by it, 0 is never handed out
+std::atomic<uint64_t> lastWalkEpoch{0};
+
+struct LeafWalkContext {
+    const Gpu &gpu;
+    const AllocationParams &allocationParams;
+    WalkMode mode;
+    bool isLocalMemory;
+    bool ps64Applicable;
+    uint64_t walkEpoch;
+};
+
+// Maps or revisits the leaf of pte at gfxAddress and emits its PTE entry when it needs to be written.
+// Returns nullptr when the leaf is missing in expect mode.
+PageTableLeaf *walkLeaf(PageTableWalker &walker, const LeafWalkContext &context, PTE *pte, uint64_t gfxAddress, size_t size,
+                        uint32_t pageMemoryBank, const PageInfo *clonePageInfo, const std::optional<uint64_t> &physicalAddress) {
+    const Gpu &gpu = context.gpu;
+    const auto mode = context.mode;
+    const auto &allocationParams = context.allocationParams;
+    const auto index = pte->getIndex(gfxAddress);
+    const size_t pageSize = pte->getPageSize();
+
+    // PS64: snapshot group state before this leaf is allocated/remapped
+    const bool checkPs64 = context.ps64Applicable && pageSize == 4096;
+    if (checkPs64) {
+        pte->trackPs64Groups();
+    }
+    const uint32_t hwBase = checkPs64 ? (index & ~0xfu) : 0;
+    const PageTableLeaf *c0 = checkPs64 ? pte->getLeaf(hwBase) : nullptr;
+    const bool wasPs64Group = c0 != nullptr && c0->isPs64() && pte->isPs64GroupComplete(hwBase);
+    bool emitEntry = false;
+
+    PageTableLeaf *leaf = pte->getLeaf(index);
+    if (!leaf) {
+        assert(mode != WalkMode::Expect);
+        if (mode == WalkMode::Expect) {
+            return nullptr;
+        }
+        if (clonePageInfo) {
+            const auto physicalAddressAligned = clonePageInfo->physicalAddress & ~(static_cast<uint64_t>(pageSize - 1));
+            leaf = pte->setLeaf(index, physicalAddressAligned, clonePageInfo->memoryBank, allocationParams.additionalParams);
+        } else if (physicalAddress) {
+            leaf = pte->setLeaf(index, *physicalAddress, pageMemoryBank, allocationParams.additionalParams);
+        } else {
+            leaf = pte->allocateLeaf(index, pageMemoryBank, allocationParams.additionalParams);
+        }
+
+        leaf->setPendingWrite(true);
+        // Need to keep track of 64KB system pages
+        if (mode == WalkMode::Reserve && !context.isLocalMemory && pageSize == 65536) {
+            walker.pages64KB.push_back(leaf->getPhysicalAddress());
+        }
+        emitEntry = true;
+    }
+
+    // When using PreReserved memory via explicit Map we want to override the PTEs for remapping cases
+    if (physicalAddress) {
+        if (leaf->getPhysicalAddress() != *physicalAddress) {
+            // We need to remap here
+            leaf->setPhysicalAddress(*physicalAddress);
+            leaf->setPendingWrite(true);
+            emitEntry = true;
+        }
+        if (leaf->getMemoryBank() != pageMemoryBank) {
+            leaf->setMemoryBank(pageMemoryBank);
+            leaf->setPendingWrite(true);
+            emitEntry = true;
+        }
+        if (emitEntry) {
+            pte->updatePs64Group(index);
+        }
+    }
+
+    if (checkPs64) {
+        if (pte->isPs64GroupComplete(hwBase)) {
+            // Group is now complete - emit slots not yet written as PS64 or pending stream commit
+            for (uint32_t i = 0; i < 16; i++) {
+                PageTableLeaf *ci = pte->getLeaf(hwBase + i);
+                bool isNewPs64 = !ci->isPs64();
+                if (isNewPs64) {
+                    ci->setPs64(true);
+                    ci->setPendingWrite(true);
+                }
+                bool isNewPending = ci->isPendingWrite() && pte->markLeafEmitted(hwBase + i, context.walkEpoch);
+                // isNewPs64=true with an already marked leaf is intentional: a wasPs64Group downgrade in an
+                // earlier iteration marked ci as emitted (non-PS64 entry already emitted),
+                // and this completion pass re-emits ci with the PS64 bit set. The stream receives
+                // the updated value; the leaf is already tracked in pendingLeaves for clearing.
+                if (isNewPs64 || isNewPending) {
+                    walker.pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + (hwBase + i) * sizeof(uint64_t),
+                                                                           ci->getEntryValue(gpu)});
+                }
+                if (isNewPending) {
+                    walker.pendingLeaves.push_back(ci);
+                }
+            }
+            emitEntry = false;
+        } else if (wasPs64Group) {
+            // Group was PS64-complete but is no longer consecutive - clear PS64 on each leaf
+            for (uint32_t i = 0; i < 16; i++) {
+                PageTableLeaf *ci = pte->getLeaf(hwBase + i);
+                assert(ci != nullptr);
+                ci->setPs64(false);
+                ci->setPendingWrite(true);
+                walker.pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + (hwBase + i) * sizeof(uint64_t),
+                                                                       ci->getEntryValue(gpu)});
+                if (pte->markLeafEmitted(hwBase + i, context.walkEpoch)) {
+                    walker.pendingLeaves.push_back(ci);
+                }
+            }
+            emitEntry = false;
+        } else {
+            const uint32_t k = index - hwBase;
+            const uint64_t expectedPhysBase = leaf->getPhysicalAddress() - static_cast<uint64_t>(k) * 4096;
+            const bool willComplete = (expectedPhysBase & 0xffff) == 0 &&
+                                      size >= static_cast<size_t>(16 - k) * 4096 &&
+                                      (k == 0 || (c0 != nullptr &&
+                                                  c0->getPhysicalAddress() == expectedPhysBase &&
+                                                  pte->getPs64EntryFlags(*c0) == pte->getPs64EntryFlags(*leaf)));
+            if (willComplete) {
+                leaf->setPs64(true);
+                leaf->setPendingWrite(true);
+            }
+            emitEntry = true;
+        }
+    } else {
+        // Without PS64 group passes every leaf is visited once per walk, so no emitted mark is needed
+        emitEntry = emitEntry || physicalAddress.has_value();
+        if (leaf->isPendingWrite()) {
+            walker.pendingLeaves.push_back(leaf);
+            emitEntry = true;
+        }
+    }
+    if (emitEntry) {
+        walker.pageWalkEntries[PageTableLevel::Pte].push_back({pte->getPhysicalAddress() + index * sizeof(uint64_t),
+                                                               leaf->getEntryValue(gpu)});
+        if (checkPs64 && leaf->isPendingWrite() && pte->markLeafEmitted(index, context.walkEpoch)) {
+            walker.pendingLeaves.push_back(leaf);
+        }
+    }
+    return leaf;
 }
 
-// Returns true when all 16 hardware PTE slots of the naturally-aligned 64KB group
-// starting at hwBase are occupied by children with consecutive physical addresses
-// and identical permission bits (PS64 spec: same perms, 64KB-aligned PA).
-inline bool isPs64GroupComplete(PageTable *parent, uint32_t hwBase) {
-    PageTable *c0 = parent->getChild(hwBase);
-    if (!c0)
-        return false;
-    const uint64_t base = c0->getPhysicalAddress();
-    if (base & 0xffff)
+// Expect walks up to this size are answered from the translation cache of the root
+constexpr size_t maxTranslatedWalkSize = TranslationCache::entryCount * 4096;
+
+bool translateAddress(PageTable *ppgtt, uint64_t gfxAddress, TranslationCache::Translation &translation) {
+    PageTable *table = ppgtt;
+    for (int level = ppgtt->getNumLevels() - 1; level > PageTableLevel::Pte; --level) {
+        table = table->getChild(table->getIndex(gfxAddress));
+        if (!table) {
+            return false;
+        }
+        if (table->getPageSize() == Page2MB::pageSize2MB) {
+            translation = {table->getPhysicalAddress(), Page2MB::pageSize2MB, table->isLocalMemory()};
+            return true;
+        }
+    }
+    auto *pte = static_cast<PTE *>(table);
+    auto *leaf = pte->getLeaf(pte->getIndex(gfxAddress));
+    if (!leaf) {
         return false;
-    const uint64_t flags0 = ps64EntryFlags(c0);
-    for (uint32_t i = 1; i < 16; i++) {
-        PageTable *ci = parent->getChild(hwBase + i);
-        if (!ci || ci->getPhysicalAddress() != base + i * 4096)
-            return false; // must be consecutive physical addresses
-        if (ps64EntryFlags(ci) != flags0)
-            return false; // must have the same flags (e.g. permissions)
+    }
+    translation = {leaf->getPhysicalAddress(), pte->getPageSize(), leaf->isLocalMemory()};
+    return true;
+}
+
+// Fills the page entries of an expect walk from cached translations, descending the tree only on misses.
+// Returns false without side effects when part of the range is not mapped, the tree walk handles it.
+bool translateMemory(PageTableWalker &walker, PageTable *ppgtt, MemoryBankHelper &bankHelper, uint64_t gfxAddress, size_t size) {
+    auto &translationCache = ppgtt->getTranslationCache();
+    const auto firstEntry = walker.entries.size();
+    while (size > 0) {
+        TranslationCache::Translation translation;
+        if (!translationCache.lookup(gfxAddress, translation)) {
+            if (!translateAddress(ppgtt, gfxAddress, translation)) {
+                walker.entries.resize(firstEntry);
+                return false;
+            }
+            translationCache.insert(gfxAddress, translation);
+        }
+
+        auto pageOffset = gfxAddress & (translation.pageSize - 1);
+        auto sizeThisIteration = std::min(size, static_cast<size_t>(translation.pageSize - pageOffset));
+        walker.entries.push_back({translation.physicalAddress + pageOffset, sizeThisIteration, translation.isLocalMemory, bankHelper.getMemoryBank(gfxAddress)});
+        gfxAddress += sizeThisIteration;
+        size -= sizeThisIteration;
+    }
+    return true;
+}
+
+thread_local std::vector<std::unique_ptr<PageTableWalker>> walkerPool;
+
+size_t getParallelWalkThreadCount() {
+    auto threadCount = globalSettings->PageTableWalkThreads.get();
+    if (threadCount >= 0) {
+        return static_cast<size_t>(threadCount);
+    }
+    return std::min<size_t>(4, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Walks a range whose interior tables and leaves all exist, with the PTEs split across threadCount threads.
+// Nothing is allocated, so results of each thread only depend on its PTEs and are appended in address order,
+// matching the serial walk entry for entry. Returns false without side effects when part of the range is not
+// mapped, has pending interior tables or uses 2MB pages, those ranges are walked serially.
+bool walkMappedMemoryInParallel(PageTableWalker &walker, const LeafWalkContext &context, PageTable *ppgtt, MemoryBankHelper &bankHelper,
+                                uint64_t gfxAddress, size_t size, size_t threadCount) {
+    struct PteRange {
+        PTE *pte;
+        uint64_t gfxAddress;
+        size_t size;
+    };
+    std::vector<PteRange> pteRanges;
+    pteRanges.reserve(2 + size / Page2MB::pageSize2MB);
+
+    const uint64_t walkEnd = gfxAddress + size;
+    for (uint64_t address = gfxAddress; address < walkEnd;) {
+        PageTable *table = ppgtt;
+        for (int level = ppgtt->getNumLevels() - 1; level > PageTableLevel::Pte; --level) {
+            table = table->getChild(table->getIndex(address));
+            if (!table || table->isPendingWrite() || table->getPageSize() == Page2MB::pageSize2MB) {
+                return false;
+            }
+        }
+        auto *pte = static_cast<PTE *>(table);
+        const uint64_t rangeEnd = std::min(walkEnd, (address & ~static_cast<uint64_t>(Page2MB::pageSize2MB - 1)) + Page2MB::pageSize2MB);
+
+        // New leaves reserve physical memory, which has to happen in serial walk order
+        const uint64_t pageMask = ~static_cast<uint64_t>(pte->getPageSize() - 1);
+        const uint64_t firstPage = address & pageMask;
+        const uint64_t lastPage = (rangeEnd - 1) & pageMask;
+        if (pte->countLeavesInRange(pte->getIndex(firstPage), pte->getIndex(lastPage) + 1) != (lastPage - firstPage) / pte->getPageSize() + 1) {
+            return false;
+        }
+        pteRanges.push_back({pte, address, static_cast<size_t>(rangeEnd - address)});
+        address = rangeEnd;
+    }
+
+    threadCount = std::min(threadCount, pteRanges.size());
+    std::vector<PageTableWalker> partialWalkers(threadCount);
+    auto walkPteRanges = [&](size_t part) {
+        auto &partialWalker = partialWalkers[part];
+        const std::optional<uint64_t> noPhysicalAddress;
+        for (auto i = pteRanges.size() * part / threadCount; i < pteRanges.size() * (part + 1) / threadCount; i++) {
+            auto *pte = pteRanges[i].pte;
+            const size_t pageSize = pte->getPageSize();
+            auto address = pteRanges[i].gfxAddress;
+            auto remaining = pteRanges[i].size;
+            while (remaining > 0) {
+                uint32_t pageMemoryBank = bankHelper.getMemoryBank(address);
+                auto leaf = walkLeaf(partialWalker, context, pte, address, static_cast<size_t>(walkEnd - address), pageMemoryBank, nullptr, noPhysicalAddress);
+                assert(leaf != nullptr);
+
+                auto pageOffset = address & (pageSize - 1);
+                auto sizeThisIteration = std::min(remaining, static_cast<size_t>(pageSize - pageOffset));
+                partialWalker.entries.push_back({leaf->getPhysicalAddress() + pageOffset, sizeThisIteration, leaf->isLocalMemory(), pageMemoryBank});
+                address += sizeThisIteration;
+                remaining -= sizeThisIteration;
+            }
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (size_t part = 1; part < threadCount; part++) {
+        workers.push_back(std::async(std::launch::async, walkPteRanges, part));
+    }
+    walkPteRanges(0);
+    for (auto &worker : workers) {
+        worker.get();
+    }
+
+    for (auto &partialWalker : partialWalkers) {
+        auto append = [](auto &destination, const auto &source) {
+            destination.insert(destination.end(), source.begin(), source.end());
+        };
+        append(walker.entries, partialWalker.entries);
+        append(walker.pageWalkEntries[PageTableLevel::Pte], partialWalker.pageWalkEntries[PageTableLevel::Pte]);
+        append(walker.pendingLeaves, partialWalker.pendingLeaves);
+        append(walker.pages64KB, partialWalker.pages64KB);
     }
     return true;
 }
@@ -65,6 +329,7 @@ inline bool isPs64GroupComplete(PageTable *parent, uint32_t hwBase) {
 } // namespace
 
 void PageTableWalker::walkMemory(GGTT *ggtt, uint64_t gfxAddress, size_t size, uint32_t memoryBanks, size_t pageSize, WalkMode mode, const std::vector<PageInfo> *pageInfos) {
+    ScopedOperationTimer timer(OperationType::pageTableWalk, size);
     auto &ggttEntries = pageWalkEntries[0];
 
     bool isLocalMemory = memoryBanks != PhysicalAddressAllocator::mainBank;
@@ -72,44 +337,26 @@ void PageTableWalker::walkMemory(GGTT *ggtt, uint64_t gfxAddress, size_t size, u
     entries.reserve(2 + (size / 4096));
     ggttEntries.reserve(2 + (size / 4096));
 
+    const bool isPageLocalMemory = ggtt->isLocalMemory();
+    const auto entriesPerPage = static_cast<unsigned int>(pageSize / 4096);
+
     while (size > 0) {
         auto pageOffset = gfxAddress & (pageSize - 1);
-        auto gpuAddressAligned = uint32_t(gfxAddress - pageOffset);
+        auto index = ggtt->getIndex(gfxAddress - pageOffset);
 
-        auto index = ggtt->getIndex(gpuAddressAligned);
-        auto child = ggtt->getChild(index);
-        if (child == nullptr) {
+        auto entry = ggtt->getEntry(index);
+        if (entry == 0) {
             assert(mode != WalkMode::Expect);
             if (mode == WalkMode::Expect) {
                 break;
             }
 
-            child = ggtt->allocateChild(ggtt->getGpu(), pageSize, ggtt->getMemoryBank());
-
-            ggtt->setChild(index, child);
-
-            auto enableBits = isLocalMemory ? 3
-                                            : 1;
-
-            {
-                PageEntryInfo writeInfo = {
-                    ggtt->getEntryOffset() + sizeof(uint64_t) * index,
-                    child->getPhysicalAddress() | enableBits};
-
-                ggttEntries.push_back(writeInfo);
-            }
-
-            auto entriesToDump = pageSize / 4096;
-            auto physAddress = child->getPhysicalAddress();
-            for (auto i = 1u; i < entriesToDump; i++) {
-                physAddress += 4096;
-                ggtt->setChild(index + i, new PageTable(ggtt->getGpu(), physAddress, child->getMemoryBank()));
-
-                PageEntryInfo writeInfo = {
-                    ggtt->getEntryOffset() + sizeof(uint64_t) * (index + i),
-                    physAddress | enableBits};
-                ggttEntries.push_back(writeInfo);
+            const uint64_t *pageEntries = ggtt->mapPage(index, pageSize, isLocalMemory);
+            const uint64_t entryAddress = ggtt->getEntryOffset() + sizeof(uint64_t) * index;
+            for (auto i = 0u; i < entriesPerPage; i++) {
+                ggttEntries.push_back({entryAddress + sizeof(uint64_t) * i, pageEntries[i]});
             }
+            entry = pageEntries[0];
         }
 
         auto sizeThisPass = static_cast<size_t>(pageSize - pageOffset);
@@ -117,9 +364,9 @@ void PageTableWalker::walkMemory(GGTT *ggtt, uint64_t gfxAddress, size_t size, u
 
         // Record our PTE information
         PageInfo writeInfo = {
-            child->getPhysicalAddress() + pageOffset,
+            (entry & GGTT::physicalAddressMask) + pageOffset,
             sizeThisPass,
-            child->isLocalMemory()};
+            isPageLocalMemory};
         entries.push_back(writeInfo);
 
         size -= sizeThisPass;
@@ -132,6 +379,7 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
     if (size == 0) {
         return;
     }
+    ScopedOperationTimer timer(OperationType::pageTableWalk, size);
 
     auto pageSize = allocationParams.pageSize;
     auto memoryBanks = allocationParams.memoryBanks;
@@ -158,6 +406,14 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
     const int requestedLeafLevel = leafLevel;
     const bool ps64Applicable = globalSettings->EnablePs64.get() && requestedPageSize == 4096 && ppgtt->getNumLevels() == 5; // PS64 was introduced with 5-level PPGTT (PML5)
 
+    if (mode == WalkMode::Expect) {
+        if (size <= maxTranslatedWalkSize && translateMemory(*this, ppgtt, bankHelper, gfxAddress, size)) {
+            return;
+        }
+    } else {
+        ppgtt->invalidateTranslations(gfxAddress, size);
+    }
+
     // Reserve # of entries plus two for leading/trailing pages
     pageWalkEntries[PageTableLevel::Pml5].reserve(2 + (uint64_t(size) >> 48));
     pageWalkEntries[PageTableLevel::Pml4].reserve(2 + (uint64_t(size) >> 39));
@@ -167,8 +423,24 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
     pages64KB.reserve(2 + (uint64_t(size) / pageSize));
     entries.reserve(2 + (uint64_t(size) / pageSize));
 
-    // Per-walk set to emit each pending node at most once; interior nodes are shared across pages
-    std::unordered_set<PageTable *> emittedPending[5];
+    // Each pending node or leaf is emitted at most once per walk; interior nodes are shared across pages
+    const uint64_t walkEpoch = ++lastWalkEpoch;
+
+    const Gpu &gpu = ppgtt->getGpu();
+    const LeafWalkContext leafWalkContext = {gpu, allocationParams, mode, isLocalMemory, ps64Applicable, walkEpoch};
+
+    if (!physicalAddress && mode != WalkMode::Clone && requestedLeafLevel == PageTableLevel::Pte && size >= parallelWalkMinSize) {
+        auto threadCount = getParallelWalkThreadCount();
+        if (threadCount > 1 && walkMappedMemoryInParallel(*this, leafWalkContext, ppgtt, bankHelper, gfxAddress, size, threadCount)) {
+            return;
+        }
+    }
+
+    // PTE reached by the last descent and the 2MB range it maps. Consecutive pages in that range reuse it instead of
+    // descending from the root again, interior entries were already emitted by the first page of the range.
+    // Explicit physical mappings re-emit interior entries for every page, so they always descend.
+    PTE *rangePte = nullptr;
+    uint64_t rangePteStart = 0;
 
     while (size > 0) {
         // Reset per-iteration. Conflict fallback is scoped to a single PDE
@@ -184,18 +456,17 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
         if (mode == WalkMode::Clone) {
             clonePageInfo = &(*pageInfos)[clonePageInfoIndex++];
         }
-        PTE *pte = nullptr;
-        while (level >= leafLevel) {
-            parent = child;
-            auto index = parent->getIndex(gfxAddress);
 
-            // PTE only exists at level 0
-            pte = (level == PageTableLevel::Pte) ? static_cast<PTE *>(parent) : nullptr;
+        if (rangePte && (gfxAddress & ~static_cast<uint64_t>(Page2MB::pageSize2MB - 1)) == rangePteStart) {
+            child = rangePte;
+            leafLevel = PageTableLevel::Pte;
+            level = PageTableLevel::Pte;
+        }
 
-            // Existing PTE determines actual page size
-            if (pte && pte->getPageSize() != pageSize) {
-                pageSize = pte->getPageSize();
-            }
+        // Interior levels and 2MB pages, PTE leaves are packed entries handled below
+        while (level >= leafLevel && level > PageTableLevel::Pte) {
+            parent = child;
+            auto index = parent->getIndex(gfxAddress);
 
             // Get or allocate each of the page structures
             child = parent->getChild(index);
@@ -220,12 +491,6 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
                 *physicalAddress = (*physicalAddress & ~(Page2MB::pageSize2MB - 1)) + Page2MB::pageSize2MB;
             }
 
-            // PS64: snapshot group state before this child is allocated/remapped
-            const bool checkPs64 = ps64Applicable && level == PageTableLevel::Pte && pte != nullptr &&
-                                   pte->getPageSize() == 4096;
-            const uint32_t hwBase = checkPs64 ? (index & ~0xfu) : 0;
-            const PageTable *c0 = checkPs64 ? parent->getChild(hwBase) : nullptr;
-            const bool wasPs64Group = c0 != nullptr && c0->isPs64() && isPs64GroupComplete(parent, hwBase);
             bool emitEntry = false;
 
             if (!child) {
@@ -235,29 +500,21 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
                 }
                 if (level == leafLevel && clonePageInfo) {
                     const auto physicalAddressAligned = clonePageInfo->physicalAddress & ~(static_cast<uint64_t>(pageSize - 1));
-                    if (pageSize == Page2MB::pageSize2MB) {
-                        child = new Page2MB(ppgtt->getGpu(), physicalAddressAligned, clonePageInfo->memoryBank, allocationParams.additionalParams);
-                    } else {
-                        child = new PageTableMemory(ppgtt->getGpu(), physicalAddressAligned, clonePageInfo->memoryBank, allocationParams.additionalParams);
-                    }
+                    child = ppgtt->getArena().create<Page2MB>(gpu, physicalAddressAligned, clonePageInfo->memoryBank, allocationParams.additionalParams);
                 } else if (level != leafLevel) {
                     // For interior nodes, child use parent's memory bank
-                    child = parent->allocateChild(ppgtt->getGpu(), pageSize, parent->getMemoryBank());
+                    child = parent->allocateChild(gpu, pageSize, parent->getMemoryBank());
                 } else {
                     // for child node use memory bank previously reserved
                     if (physicalAddress) {
-                        child = parent->allocateChild(ppgtt->getGpu(), pageSize, pageMemoryBank, allocationParams.additionalParams, *physicalAddress);
+                        child = parent->allocateChild(gpu, pageSize, pageMemoryBank, allocationParams.additionalParams, *physicalAddress);
                     } else {
-                        child = parent->allocateChild(ppgtt->getGpu(), pageSize, pageMemoryBank, allocationParams.additionalParams);
+                        child = parent->allocateChild(gpu, pageSize, pageMemoryBank, allocationParams.additionalParams);
                     }
                 }
 
                 parent->setChild(index, child);
                 child->setPendingWrite(true);
-                // Need to keep track of 64KB system pages
-                if (level == PageTableLevel::Pte && mode == WalkMode::Reserve && !isLocalMemory && pageSize == 65536) {
-                    pages64KB.push_back(child->getPhysicalAddress());
-                }
                 emitEntry = true;
             }
 
@@ -276,73 +533,16 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
                 }
             }
 
-            if (checkPs64) {
-                if (isPs64GroupComplete(parent, hwBase)) {
-                    // Group is now complete - emit slots not yet written as PS64 or pending stream commit
-                    for (uint32_t i = 0; i < 16; i++) {
-                        PageTable *ci = parent->getChild(hwBase + i);
-                        bool isNewPs64 = !ci->isPs64();
-                        if (isNewPs64) {
-                            ci->setPs64(true);
-                            ci->setPendingWrite(true);
-                        }
-                        bool isNewPending = ci->isPendingWrite() && emittedPending[level].insert(ci).second;
-                        // isNewPs64=true with insert=false is intentional: a wasPs64Group downgrade in an
-                        // earlier iteration inserted ci into emittedPending (non-PS64 entry already emitted),
-                        // and this completion pass re-emits ci with the PS64 bit set. The stream receives
-                        // the updated value; the node is already tracked in pendingNodes for clearing.
-                        if (isNewPs64 || isNewPending) {
-                            pageWalkEntries[level].push_back({parent->getPhysicalAddress() + (hwBase + i) * sizeof(uint64_t),
-                                                              ci->getEntryValue()});
-                        }
-                        if (isNewPending) {
-                            pendingNodes[level].push_back(ci);
-                        }
-                    }
-                    emitEntry = false;
-                } else if (wasPs64Group) {
-                    // Group was PS64-complete but is no longer consecutive - clear PS64 on each leaf
-                    for (uint32_t i = 0; i < 16; i++) {
-                        PageTable *ci = parent->getChild(hwBase + i);
-                        assert(ci != nullptr);
-                        ci->setPs64(false);
-                        ci->setPendingWrite(true);
-                        pageWalkEntries[level].push_back({parent->getPhysicalAddress() + (hwBase + i) * sizeof(uint64_t),
-                                                          ci->getEntryValue()});
-                        if (emittedPending[level].insert(ci).second) {
-                            pendingNodes[level].push_back(ci);
-                        }
-                    }
-                    emitEntry = false;
-                } else {
-                    const uint32_t k = index - hwBase;
-                    const uint64_t expectedPhysBase = child->getPhysicalAddress() - static_cast<uint64_t>(k) * 4096;
-                    const bool willComplete = (expectedPhysBase & 0xffff) == 0 &&
-                                              size >= static_cast<size_t>(16 - k) * 4096 &&
-                                              (k == 0 || (c0 != nullptr &&
-                                                          c0->getPhysicalAddress() == expectedPhysBase &&
-                                                          ps64EntryFlags(c0) == ps64EntryFlags(child)));
-                    if (willComplete) {
-                        child->setPs64(true);
-                        child->setPendingWrite(true);
-                    }
+            emitEntry = emitEntry || physicalAddress.has_value();
+            if (child->isPendingWrite()) {
+                if (child->markEmitted(walkEpoch)) {
+                    pendingNodes[level].push_back(child);
                     emitEntry = true;
                 }
-            } else {
-                emitEntry = emitEntry || physicalAddress.has_value();
-                if (child->isPendingWrite()) {
-                    if (emittedPending[level].insert(child).second) {
-                        pendingNodes[level].push_back(child);
-                        emitEntry = true;
-                    }
-                }
             }
             if (emitEntry) {
                 pageWalkEntries[level].push_back({parent->getPhysicalAddress() + index * sizeof(uint64_t),
                                                   child->getEntryValue()});
-                if (checkPs64 && child->isPendingWrite() && emittedPending[level].insert(child).second) {
-                    pendingNodes[level].push_back(child);
-                }
             }
             --level;
         }
@@ -351,14 +551,26 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
             break;
         }
 
-        // pte is null for 2MB pages
-        size_t pageSizeThisIteration;
-        if (pageSize == Page2MB::pageSize2MB) {
-            pageSizeThisIteration = Page2MB::pageSize2MB;
-        } else {
-            assert(pte);
-            pageSizeThisIteration = pte->getPageSize(); // NOLINT(clang-analyzer-core.CallAndMessage)
+        PageTableLeaf *leaf = nullptr;
+        if (leafLevel == PageTableLevel::Pte) {
+            auto *pte = static_cast<PTE *>(child);
+
+            if (!physicalAddress) {
+                rangePte = pte;
+                rangePteStart = gfxAddress & ~static_cast<uint64_t>(Page2MB::pageSize2MB - 1);
+            }
+
+            // Existing PTE determines actual page size
+            pageSize = pte->getPageSize();
+
+            leaf = walkLeaf(*this, leafWalkContext, pte, gfxAddress, size, pageMemoryBank, clonePageInfo, physicalAddress);
+            if (!leaf) {
+                break;
+            }
         }
+
+        // leaf is null for 2MB pages
+        const size_t pageSizeThisIteration = pageSize;
         assert(pageSizeThisIteration == 4096 || pageSizeThisIteration == 65536 || pageSizeThisIteration == Page2MB::pageSize2MB);
 
         auto pageOffset = gfxAddress & (pageSizeThisIteration - 1);
@@ -367,9 +579,9 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
 
         // Record page information
         PageInfo writeInfo = {
-            child->getPhysicalAddress() + pageOffset,
+            (leaf ? leaf->getPhysicalAddress() : child->getPhysicalAddress()) + pageOffset,
             sizeThisIteration,
-            child->isLocalMemory(),
+            leaf ? leaf->isLocalMemory() : child->isLocalMemory(),
             pageMemoryBank};
         entries.push_back(writeInfo);
 
@@ -386,6 +598,34 @@ void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &alloc
     }
 }
 
+void PageTableWalker::clear() {
+    entries.clear();
+    for (int level = 0; level < 5; level++) {
+        pageWalkEntries[level].clear();
+        pendingNodes[level].clear();
+    }
+    pendingLeaves.clear();
+    pages64KB.clear();
+}
+
+PooledPageTableWalker::PooledPageTableWalker() {
+    if (walkerPool.empty()) {
+        walker = std::make_unique<PageTableWalker>();
+        return;
+    }
+    walker = std::move(walkerPool.back());
+    walkerPool.pop_back();
+}
+
+PooledPageTableWalker::~PooledPageTableWalker() {
+    if (walkerPool.size() >= maxPooledWalkers || walker->entries.capacity() > maxPooledEntries) {
+        return;
+    }
+    walker->clear();
+    walkerPool.reserve(maxPooledWalkers);
+    walkerPool.push_back(std::move(walker));
+}
+
 void PageTableWalker::walkMemory(PageTable *ppgtt, const AllocationParams &allocationParams, WalkMode mode, const std::vector<PageInfo> *pageInfos) {
     walkMemory(ppgtt, allocationParams, mode, pageInfos, std::nullopt);
 }
@@ -10,6 +10,7 @@
 #include "aub_mem_dump/page_table.h"
 #include "aubstream/page_info.h"
 #include "aubstream/allocation_params.h"
+#include <memory>
 #include <optional>
 
 namespace aub_stream {
@@ -28,17 +29,45 @@ class PageTableWalker {
         Expect
     };
 
+    // Walks at least this large over existing page tables are split by PTE across PageTableWalkThreads threads
+    static constexpr size_t parallelWalkMinSize = 1024 * 1024 * 1024;
+
     std::vector<PageInfo> entries;
     std::vector<PageEntryInfo> pageWalkEntries[5];
     std::vector<PageTable *> pendingNodes[5];
+    std::vector<PageTableLeaf *> pendingLeaves; // PTE level, leaves are packed entries rather than nodes
     std::vector<uint64_t> pages64KB;
 
     void walkMemory(GGTT *pageTable, uint64_t gfxAddress, size_t size, uint32_t memoryBanks, size_t pageSize, WalkMode mode, const std::vector<PageInfo> *pageInfos);
     void walkMemory(PageTable *pageTable, const AllocationParams &allocationParams, WalkMode mode, const std::vector<PageInfo> *pageInfos);
     void walkMemory(PageTable *pageTable, const AllocationParams &allocationParams, WalkMode mode, const std::vector<PageInfo> *pageInfos, uint64_t physicalAddress);
 
+    // Empties all vectors but keeps their capacity for the next walk
+    void clear();
+
   protected:
     void walkMemory(PageTable *ppgtt, const AllocationParams &allocationParams, WalkMode mode, const std::vector<PageInfo> *pageInfos, std::optional<uint64_t> physicalAddress);
 };
 
+// Walker borrowed from a per-thread pool for the scope of one stream operation. Pooled walkers keep the capacity
+// of their vectors, so repeated walks of similar size don't allocate. Nested operations borrow separate walkers.
+class PooledPageTableWalker {
+  public:
+    // Walkers that grew beyond this many page entries are freed instead of pinning their buffers in the pool
+    static constexpr size_t maxPooledEntries = 64 * 1024;
+    static constexpr size_t maxPooledWalkers = 4;
+
+    PooledPageTableWalker();
+    ~PooledPageTableWalker();
+
+    PooledPageTableWalker(const PooledPageTableWalker &) = delete;
+    PooledPageTableWalker &operator=(const PooledPageTableWalker &) = delete;
+
+    PageTableWalker &operator*() const { return *walker; }
+    PageTableWalker *operator->() const { return walker.get(); }
+
+  protected:
+    std::unique_ptr<PageTableWalker> walker;
+};
+
 } // namespace aub_stream
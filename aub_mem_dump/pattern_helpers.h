@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace aub_stream {
+
+// Returns true when size is a non-zero multiple of a dword and every dword equals the first one, which is returned in value.
+// The 64-byte blocks are compared with a branch-free OR of XORs so the compiler vectorizes the inner loop.
+inline bool isUniformDwordPattern(const void *data, size_t size, uint32_t &value) {
+    if (size == 0 || (size & (sizeof(uint32_t) - 1))) {
+        return false;
+    }
+    auto bytes = static_cast<const uint8_t *>(data);
+    memcpy(&value, bytes, sizeof(value));
+    const uint64_t pattern = (static_cast<uint64_t>(value) << 32) | value;
+
+    constexpr size_t wordsPerBlock = 8;
+    constexpr size_t blockSize = wordsPerBlock * sizeof(uint64_t);
+    size_t offset = 0;
+    for (; offset + blockSize <= size; offset += blockSize) {
+        uint64_t words[wordsPerBlock];
+        memcpy(words, bytes + offset, blockSize);
+        uint64_t difference = 0;
+        for (size_t i = 0; i < wordsPerBlock; i++) {
+            difference |= words[i] ^ pattern;
+        }
+        if (difference) {
+            return false;
+        }
+    }
+    for (; offset < size; offset += sizeof(uint32_t)) {
+        uint32_t dword;
+        memcpy(&dword, bytes + offset, sizeof(dword));
+        if (dword != value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace aub_stream
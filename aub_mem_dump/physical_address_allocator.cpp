@@ -7,9 +7,55 @@
 
 #include "physical_address_allocator.h"
 #include <cassert>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
 
 namespace aub_stream {
 
+namespace {
+
+uint8_t *mapHostMemory(size_t size) {
+#if defined(_WIN32)
+    auto p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    auto p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        p = nullptr;
+    }
+#if defined(MADV_HUGEPAGE)
+    if (p) {
+        madvise(p, size, MADV_HUGEPAGE);
+    }
+#endif
+#endif
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return static_cast<uint8_t *>(p);
+}
+
+void unmapHostMemory(uint8_t *p, size_t size) {
+#if defined(_WIN32)
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, size);
+#endif
+}
+
+uintptr_t alignUpAddress(uintptr_t address, size_t alignment) {
+    return (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+} // namespace
+
 PhysicalAddressAllocatorSimple::PhysicalAddressAllocatorSimple(uint32_t numberOfAllocators, uint64_t singleAllocatorSize, bool localMemorySupport) : mainAllocator(reservedGGTTSpace),
                                                                                                                                                      numberOfAllocators(numberOfAllocators),
                                                                                                                                                      allocatorSize(singleAllocatorSize) {
@@ -22,9 +68,11 @@ PhysicalAddressAllocatorSimple::PhysicalAddressAllocatorSimple(uint32_t numberOf
     }
 }
 
-uint64_t PhysicalAddressAllocatorSimple::reservePhysicalMemory(uint32_t memoryBank, size_t size, size_t alignment) {
+std::atomic<uint64_t> PhysicalAddressAllocatorSimple::lastAllocatorId{0};
+
+uint32_t PhysicalAddressAllocatorSimple::getAllocatorIndex(uint32_t memoryBank) const {
     if (memoryBank == 0 || numberOfAllocators == 0) {
-        return mainAllocator.alignedAlloc(size, alignment);
+        return 0;
     }
 
     uint32_t allocatorIndex = 0;
@@ -35,35 +83,199 @@ uint64_t PhysicalAddressAllocatorSimple::reservePhysicalMemory(uint32_t memoryBa
 
     assert(allocatorIndex < allocators.size());
 
-    return allocators[allocatorIndex]->alignedAlloc(size, alignment);
+    return allocatorIndex + 1;
 }
 
-void PhysicalAddressAllocatorSimple::freePhysicalMemory(uint32_t memoryBank, uint64_t address) {
-    if (memoryBank == 0 || numberOfAllocators == 0) {
-        return mainAllocator.alignedFree(address);
+PhysicalAddressAllocatorSimple::ThreadMagazines &PhysicalAddressAllocatorSimple::getThreadMagazines() {
+    struct CachedMagazines {
+        uint64_t allocatorId;
+        ThreadMagazines *magazines;
+    };
+    thread_local CachedMagazines cached = {0, nullptr};
+    if (cached.allocatorId == allocatorId) {
+        return *cached.magazines;
     }
 
-    uint32_t allocatorIndex = 0;
-    while ((memoryBank & 1u) == 0) {
-        memoryBank >>= 1;
-        allocatorIndex++;
+    std::lock_guard<std::mutex> guard(threadMagazinesMutex);
+    auto &magazines = threadMagazines[std::this_thread::get_id()];
+    if (!magazines) {
+        magazines = std::make_unique<ThreadMagazines>(allocators.size() + 1);
     }
+    cached = {allocatorId, magazines.get()};
+    return *magazines;
+}
 
-    assert(allocatorIndex < allocators.size());
+uint64_t PhysicalAddressAllocatorSimple::reserveChunk(uint32_t allocatorIndex, size_t chunkSizeIndex) {
+    auto &magazine = getThreadMagazines()[allocatorIndex][chunkSizeIndex];
+    auto &allocator = getAllocator(allocatorIndex);
+    const auto chunkSize = magazineChunkSizes[chunkSizeIndex];
+
+    if (magazine.chunks.empty()) {
+        if (magazine.refillCount == 0) {
+            uint64_t address = 0;
+            if (allocator.tryAlignedAlloc(chunkSize, chunkSize, address)) {
+                return address;
+            }
+            magazine.refillCount = minMagazineRefill;
+        } else {
+            magazine.refillCount = std::min(magazine.refillCount * 2, maxMagazineRefill[chunkSizeIndex]);
+        }
+
+        // Handed out from the back, so the lowest address of the batch goes first
+        magazine.chunks.resize(magazine.refillCount);
+        allocator.alignedAllocBatch(chunkSize, chunkSize, magazine.chunks.data(), magazine.chunks.size());
+        std::reverse(magazine.chunks.begin(), magazine.chunks.end());
+    }
 
-    return allocators[allocatorIndex]->alignedFree(address);
+    const auto address = magazine.chunks.back();
+    magazine.chunks.pop_back();
+    return address;
+}
+
+uint64_t PhysicalAddressAllocatorSimple::reservePhysicalMemory(uint32_t memoryBank, size_t size, size_t alignment) {
+    const auto allocatorIndex = getAllocatorIndex(memoryBank);
+
+    if (size == alignment) {
+        for (size_t chunkSizeIndex = 0; chunkSizeIndex < magazineChunkSizes.size(); chunkSizeIndex++) {
+            if (magazineChunkSizes[chunkSizeIndex] == size) {
+                return reserveChunk(allocatorIndex, chunkSizeIndex);
+            }
+        }
+    }
+
+    return getAllocator(allocatorIndex).alignedAlloc(size, alignment);
+}
+
+void PhysicalAddressAllocatorSimple::freePhysicalMemory(uint32_t memoryBank, uint64_t address) {
+    return getAllocator(getAllocatorIndex(memoryBank)).alignedFree(address);
+}
+
+PhysicalAddressAllocatorHeap::~PhysicalAddressAllocatorHeap() {
+    for (auto &chunk : chunks) {
+        unmapHostMemory(chunk.base, chunk.size);
+    }
+    for (auto &largeBlock : largeBlocks) {
+        unmapHostMemory(largeBlock.second.base, largeBlock.second.size);
+    }
+}
+
+uint32_t PhysicalAddressAllocatorHeap::getSizeClass(size_t blockSize) {
+    uint32_t sizeClass = 0;
+    while (getClassSize(sizeClass) < blockSize) {
+        sizeClass++;
+    }
+    return sizeClass;
 }
 
 uint64_t PhysicalAddressAllocatorHeap::reservePhysicalMemory(uint32_t memoryBank, size_t size, size_t alignment) {
-    auto p = std::unique_ptr<uint8_t, decltype(&aligned_free)>(reinterpret_cast<uint8_t *>(aligned_alloc(size, alignment)), &aligned_free);
-    assert(p);
     static_assert(sizeof(uint8_t *) <= sizeof(uint64_t), "Pointer type must be less or equal 64b");
-    uint64_t res = reinterpret_cast<uint64_t>(p.get());
-    storage.push_back(std::move(p));
-    return res;
+    const size_t blockSize = std::max({size, alignment, minBlockSize});
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if (blockSize > maxBlockSize) {
+        alignment = std::max(alignment, minBlockSize);
+        const size_t mappedSize = alignUpAddress(size, minBlockSize) + (alignment > minBlockSize ? alignment : 0);
+        auto base = mapHostMemory(mappedSize);
+        const uint64_t address = alignUpAddress(reinterpret_cast<uintptr_t>(base), alignment);
+        largeBlocks.insert({address, {base, mappedSize}});
+        footprint.mappedBytes += mappedSize;
+        footprint.liveBytes += mappedSize;
+        return address;
+    }
+
+    const auto sizeClass = getSizeClass(blockSize);
+    auto &freeList = freeBlocks[sizeClass];
+    uint8_t *block = nullptr;
+    if (!freeList.empty()) {
+        block = freeList.back();
+        freeList.pop_back();
+        footprint.cachedBytes -= getClassSize(sizeClass);
+    } else {
+        block = splitLargerFreeBlock(sizeClass);
+        if (!block) {
+            block = allocateFromChunks(sizeClass);
+        }
+    }
+
+    const uint64_t address = reinterpret_cast<uintptr_t>(block);
+    liveBlocks.insert({address, sizeClass});
+    footprint.liveBytes += getClassSize(sizeClass);
+    return address;
 }
 
 void PhysicalAddressAllocatorHeap::freePhysicalMemory(uint32_t memoryBank, uint64_t address) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    auto liveBlockIt = liveBlocks.find(address);
+    if (liveBlockIt != liveBlocks.end()) {
+        const auto sizeClass = liveBlockIt->second;
+        liveBlocks.erase(liveBlockIt);
+        freeBlocks[sizeClass].push_back(reinterpret_cast<uint8_t *>(static_cast<uintptr_t>(address)));
+        footprint.liveBytes -= getClassSize(sizeClass);
+        footprint.cachedBytes += getClassSize(sizeClass);
+        return;
+    }
+
+    auto largeBlockIt = largeBlocks.find(address);
+    if (largeBlockIt != largeBlocks.end()) {
+        unmapHostMemory(largeBlockIt->second.base, largeBlockIt->second.size);
+        footprint.mappedBytes -= largeBlockIt->second.size;
+        footprint.liveBytes -= largeBlockIt->second.size;
+        largeBlocks.erase(largeBlockIt);
+    }
+}
+
+HostMemoryFootprint PhysicalAddressAllocatorHeap::getFootprint() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return footprint;
+}
+
+uint8_t *PhysicalAddressAllocatorHeap::splitLargerFreeBlock(uint32_t sizeClass) {
+    for (auto largerClass = sizeClass + 1; largerClass < sizeClassCount; largerClass++) {
+        auto &freeList = freeBlocks[largerClass];
+        if (!freeList.empty()) {
+            auto block = freeList.back();
+            freeList.pop_back();
+            footprint.cachedBytes -= getClassSize(largerClass);
+            releaseRange(block + getClassSize(sizeClass), block + getClassSize(largerClass));
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+uint8_t *PhysicalAddressAllocatorHeap::allocateFromChunks(uint32_t sizeClass) {
+    const size_t classSize = getClassSize(sizeClass);
+    auto block = alignUpAddress(reinterpret_cast<uintptr_t>(chunkCursor), classSize);
+
+    if (chunkCursor == nullptr || block + classSize > reinterpret_cast<uintptr_t>(chunkEnd)) {
+        releaseRange(chunkCursor, chunkEnd);
+        auto chunk = mapHostMemory(chunkSize);
+        chunks.push_back({chunk, chunkSize});
+        footprint.mappedBytes += chunkSize;
+        chunkCursor = chunk;
+        chunkEnd = chunk + chunkSize;
+        block = alignUpAddress(reinterpret_cast<uintptr_t>(chunkCursor), classSize);
+    }
+
+    releaseRange(chunkCursor, reinterpret_cast<uint8_t *>(block));
+    chunkCursor = reinterpret_cast<uint8_t *>(block + classSize);
+    return reinterpret_cast<uint8_t *>(block);
+}
+
+// Splits [begin, end) into the largest naturally aligned blocks it holds and puts them on the free lists,
+// so neither alignment padding nor chunk tails are lost
+void PhysicalAddressAllocatorHeap::releaseRange(uint8_t *begin, uint8_t *end) {
+    while (begin < end) {
+        uint32_t sizeClass = sizeClassCount - 1;
+        while (reinterpret_cast<uintptr_t>(begin) % getClassSize(sizeClass) != 0 || begin + getClassSize(sizeClass) > end) {
+            sizeClass--;
+        }
+        freeBlocks[sizeClass].push_back(begin);
+        footprint.cachedBytes += getClassSize(sizeClass);
+        begin += getClassSize(sizeClass);
+    }
 }
 
 void PhysicalAddressAllocatorSimpleAndSHM4Mapper::translatePhysicalAddressToSystemMemory(uint64_t physAddress, size_t size, bool isLocalMemory, void *&p, size_t &availableSize) {
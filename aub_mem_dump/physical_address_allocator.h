@@ -9,62 +9,139 @@
 #include "alloc_tools.h"
 #include "aubstream/shared_mem_info.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <list>
+#include <set>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace aub_stream {
 const size_t reservedGGTTSpace = 0x80000;
 
+// Hands out 4KB-granular ranges growing from firstAddress. Freed ranges are merged with free neighbours and
+// reused best fit by size, splitting off what the size and alignment don't need. Free space ending at
+// nextAddress is given back to it rather than kept in the free lists.
 template <typename AddressType>
 struct SimpleAllocator {
+    static constexpr AddressType minAlignment = 4096u;
+
     explicit SimpleAllocator(AddressType firstAddress)
         : nextAddress(firstAddress) {
     }
 
     virtual AddressType alignedAlloc(size_t size, AddressType alignment) {
         std::lock_guard<std::mutex> guard(mutex);
+        return alignedAllocLocked(size, alignment);
+    }
 
-        auto freeAllocationIt = std::find_if(freeAllocationsMap.begin(), freeAllocationsMap.end(), [size](const std::pair<AddressType, size_t> &usedAllocation) {
-            return usedAllocation.second == size;
-        });
-
-        if (freeAllocationIt != freeAllocationsMap.end()) {
-            auto physicalAddress = freeAllocationIt->first;
-            usedAllocationsMap.insert(*freeAllocationIt);
-            freeAllocationsMap.erase(freeAllocationIt);
-            return physicalAddress;
+    // Same as alignedAlloc, but returns false instead of waiting while another thread holds the allocator
+    bool tryAlignedAlloc(size_t size, AddressType alignment, AddressType &address) {
+        std::unique_lock<std::mutex> guard(mutex, std::try_to_lock);
+        if (!guard.owns_lock()) {
+            return false;
         }
+        address = alignedAllocLocked(size, alignment);
+        return true;
+    }
 
-        alignment = std::max(alignment, AddressType(4096u));
-        nextAddress += alignment - 1;
-        nextAddress &= ~(alignment - 1);
-        auto physicalAddress = nextAddress;
-        nextAddress += AddressType(size);
-        usedAllocationsMap.insert({physicalAddress, size});
-        return physicalAddress;
+    // Reserves count blocks of the same size and alignment under a single lock
+    void alignedAllocBatch(size_t size, AddressType alignment, AddressType *addresses, size_t count) {
+        std::lock_guard<std::mutex> guard(mutex);
+        for (size_t i = 0; i < count; i++) {
+            addresses[i] = alignedAllocLocked(size, alignment);
+        }
     }
 
     virtual void alignedFree(uint64_t address) {
         std::lock_guard<std::mutex> guard(mutex);
 
         auto usedAllocationIt = usedAllocationsMap.find(static_cast<AddressType>(address));
-        if (usedAllocationIt != usedAllocationsMap.end()) {
-            freeAllocationsMap.insert(*usedAllocationIt);
-            usedAllocationsMap.erase(usedAllocationIt);
+        if (usedAllocationIt == usedAllocationsMap.end()) {
+            return;
+        }
+        auto blockAddress = usedAllocationIt->first;
+        auto blockSize = usedAllocationIt->second;
+        usedAllocationsMap.erase(usedAllocationIt);
+
+        auto nextFreeIt = freeAllocationsMap.lower_bound(blockAddress);
+        if (nextFreeIt != freeAllocationsMap.begin()) {
+            auto previousFreeIt = std::prev(nextFreeIt);
+            if (previousFreeIt->first + previousFreeIt->second == blockAddress) {
+                blockAddress = previousFreeIt->first;
+                blockSize += previousFreeIt->second;
+                removeFreeBlock(previousFreeIt->first, previousFreeIt->second);
+            }
+        }
+        if (nextFreeIt != freeAllocationsMap.end() && nextFreeIt->first == blockAddress + blockSize) {
+            blockSize += nextFreeIt->second;
+            removeFreeBlock(nextFreeIt->first, nextFreeIt->second);
+        }
+
+        if (blockAddress + blockSize == nextAddress) {
+            nextAddress = blockAddress;
+        } else {
+            addFreeBlock(blockAddress, blockSize);
         }
     }
     virtual ~SimpleAllocator() = default;
 
   protected:
+    AddressType alignedAllocLocked(size_t size, AddressType alignment) {
+        alignment = std::max(alignment, minAlignment);
+        const size_t blockSize = std::max<size_t>(alignUp(size, minAlignment), minAlignment);
+
+        // Smallest free blocks first; a block too small once aligned is skipped for the next larger one
+        for (auto freeBlockIt = freeBlocksBySize.lower_bound({blockSize, AddressType(0)}); freeBlockIt != freeBlocksBySize.end(); ++freeBlockIt) {
+            const auto [freeSize, freeAddress] = *freeBlockIt;
+            const auto address = static_cast<AddressType>(alignUp(freeAddress, alignment));
+            if (address - freeAddress > freeSize - blockSize) {
+                continue;
+            }
+            removeFreeBlock(freeAddress, freeSize);
+            addFreeBlock(freeAddress, address - freeAddress);
+            addFreeBlock(static_cast<AddressType>(address + blockSize), freeSize - blockSize - (address - freeAddress));
+            usedAllocationsMap.insert({address, blockSize});
+            return address;
+        }
+
+        const auto address = static_cast<AddressType>(alignUp(nextAddress, alignment));
+        addFreeBlock(nextAddress, address - nextAddress);
+        nextAddress = static_cast<AddressType>(address + blockSize);
+        usedAllocationsMap.insert({address, blockSize});
+        return address;
+    }
+
+    template <typename ValueType>
+    static ValueType alignUp(ValueType value, AddressType alignment) {
+        return (value + alignment - 1) & ~static_cast<ValueType>(alignment - 1);
+    }
+
+    void addFreeBlock(AddressType address, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        freeAllocationsMap.insert({address, size});
+        freeBlocksBySize.insert({size, address});
+    }
+
+    void removeFreeBlock(AddressType address, size_t size) {
+        freeAllocationsMap.erase(address);
+        freeBlocksBySize.erase({size, address});
+    }
+
     std::mutex mutex;
     AddressType nextAddress;
 
-    std::multimap<AddressType, size_t> usedAllocationsMap;
-    std::multimap<AddressType, size_t> freeAllocationsMap;
+    std::map<AddressType, size_t> usedAllocationsMap;
+    // The same free blocks ordered by address, to merge neighbours, and by size, to find the best fit
+    std::map<AddressType, size_t> freeAllocationsMap;
+    std::set<std::pair<size_t, AddressType>> freeBlocksBySize;
 };
 
 struct PhysicalAddressAllocator {
@@ -83,21 +160,87 @@ struct PhysicalAddressAllocatorSimple : public PhysicalAddressAllocator {
     uint64_t reservePhysicalMemory(uint32_t memoryBank, size_t size, size_t alignment) override;
     void freePhysicalMemory(uint32_t memoryBank, uint64_t address) override;
 
+    // Chunk sizes served from per-thread magazines when reserved at their own alignment
+    static constexpr std::array<size_t, 3> magazineChunkSizes = {0x1000, 0x10000, 0x200000};
+    static constexpr std::array<uint32_t, 3> maxMagazineRefill = {64, 16, 4};
+    static constexpr uint32_t minMagazineRefill = 4;
+
   protected:
+    // Chunks reserved ahead for one thread. A thread only refills in batches once it found the allocator
+    // contended; until then every chunk is reserved on its own, keeping addresses in allocation order.
+    struct ChunkMagazine {
+        std::vector<uint64_t> chunks;
+        uint32_t refillCount = 0;
+    };
+    // Indexed by allocator, mainAllocator first, then by chunk size
+    using ThreadMagazines = std::vector<std::array<ChunkMagazine, magazineChunkSizes.size()>>;
+
+    uint32_t getAllocatorIndex(uint32_t memoryBank) const;
+    SimpleAllocator<uint64_t> &getAllocator(uint32_t allocatorIndex) {
+        return allocatorIndex == 0 ? mainAllocator : *allocators[allocatorIndex - 1];
+    }
+    ThreadMagazines &getThreadMagazines();
+    uint64_t reserveChunk(uint32_t allocatorIndex, size_t chunkSizeIndex);
+
     SimpleAllocator<uint64_t> mainAllocator;
     uint32_t numberOfAllocators = 0;
     uint64_t allocatorSize = 0x80000000;
     std::vector<std::unique_ptr<SimpleAllocator<uint64_t>>> allocators;
+
+    static std::atomic<uint64_t> lastAllocatorId;
+    const uint64_t allocatorId = ++lastAllocatorId;
+    std::mutex threadMagazinesMutex;
+    std::map<std::thread::id, std::unique_ptr<ThreadMagazines>> threadMagazines;
 };
 
+struct HostMemoryFootprint {
+    size_t mappedBytes = 0; // obtained from the OS
+    size_t liveBytes = 0;   // currently reserved
+    size_t cachedBytes = 0; // freed or split off, kept for reuse
+};
+
+// Hands out host memory as "physical" addresses for tbxShm3. Blocks up to 2MB are rounded up to a power of two
+// size class of at least 4KB and go back to their class free list when freed. An empty class is served by splitting
+// a cached block of a larger class before carving, naturally aligned, from 32MB chunks mapped with huge page advice.
+// Bigger blocks get a mapping of their own that is unmapped on free.
 struct PhysicalAddressAllocatorHeap : public PhysicalAddressAllocator {
+    static constexpr size_t minBlockSize = 0x1000;
+    static constexpr size_t maxBlockSize = 0x200000;
+    static constexpr size_t sizeClassCount = 10; // 4KB .. 2MB
+    static constexpr size_t chunkSize = 32 * maxBlockSize;
+
     PhysicalAddressAllocatorHeap() {
     }
+    PhysicalAddressAllocatorHeap(const PhysicalAddressAllocatorHeap &) = delete;
+    PhysicalAddressAllocatorHeap &operator=(const PhysicalAddressAllocatorHeap &) = delete;
+    ~PhysicalAddressAllocatorHeap() override;
+
     uint64_t reservePhysicalMemory(uint32_t memoryBank, size_t size, size_t alignment) override;
     void freePhysicalMemory(uint32_t memoryBank, uint64_t address) override;
 
+    HostMemoryFootprint getFootprint();
+
   protected:
-    std::list<std::unique_ptr<uint8_t, decltype(&aligned_free)>> storage;
+    struct HostMapping {
+        uint8_t *base;
+        size_t size;
+    };
+
+    static uint32_t getSizeClass(size_t blockSize);
+    static size_t getClassSize(uint32_t sizeClass) { return minBlockSize << sizeClass; }
+
+    uint8_t *splitLargerFreeBlock(uint32_t sizeClass);
+    uint8_t *allocateFromChunks(uint32_t sizeClass);
+    void releaseRange(uint8_t *begin, uint8_t *end);
+
+    std::mutex mutex;
+    std::vector<HostMapping> chunks;
+    uint8_t *chunkCursor = nullptr;
+    uint8_t *chunkEnd = nullptr;
+    std::array<std::vector<uint8_t *>, sizeClassCount> freeBlocks;
+    std::unordered_map<uint64_t, uint32_t> liveBlocks; // address -> size class
+    std::map<uint64_t, HostMapping> largeBlocks;       // address -> own mapping
+    HostMemoryFootprint footprint;
 };
 
 struct PhysicalAddressAllocatorSimpleAndSHM4Mapper : public PhysicalAddressAllocatorSimple {
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include "aub_mem_dump/settings.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace aub_stream {
+
+enum class PollStatus {
+    pending,
+    matched,
+    failed,
+    timedOut
+};
+
+// Polling is done in three phases: spinCount back-to-back checks, yieldCount checks separated by
+// yielding the CPU, then checks separated by sleeps doubling from initialSleepMicroseconds up to
+// maxSleepMicroseconds. timeoutMilliseconds == 0 polls until the condition is met or fails.
+struct PollPolicy {
+    uint32_t spinCount = 16;
+    uint32_t yieldCount = 64;
+    uint32_t initialSleepMicroseconds = 1;
+    uint32_t maxSleepMicroseconds = 1000;
+    uint32_t timeoutMilliseconds = 0;
+};
+
+inline PollPolicy getTbxPollPolicy() {
+    auto toUnsigned = [](int value) { return static_cast<uint32_t>(std::max(0, value)); };
+    PollPolicy policy;
+    policy.spinCount = toUnsigned(globalSettings->TbxPollSpinCount.get());
+    policy.yieldCount = toUnsigned(globalSettings->TbxPollYieldCount.get());
+    policy.maxSleepMicroseconds = toUnsigned(globalSettings->TbxPollMaxSleepMicroseconds.get());
+    policy.timeoutMilliseconds = toUnsigned(globalSettings->TbxPollTimeoutMilliseconds.get());
+    return policy;
+}
+
+struct PollStatistics {
+    uint64_t pollCount = 0;
+    uint64_t iterationCount = 0;
+    uint64_t sleepCount = 0;
+    uint64_t timeoutCount = 0;
+    uint64_t maxIterations = 0;
+};
+
+// Calls check() until it returns a status other than PollStatus::pending or the timeout expires.
+template <typename CheckFunction>
+PollStatus poll(const PollPolicy &policy, PollStatistics &statistics, CheckFunction &&check) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::milliseconds(policy.timeoutMilliseconds);
+
+    uint64_t iterations = 0;
+    uint32_t sleepMicroseconds = std::max(1u, policy.initialSleepMicroseconds);
+    PollStatus status = PollStatus::pending;
+
+    while (true) {
+        ++iterations;
+        status = check();
+        if (status != PollStatus::pending) {
+            break;
+        }
+        if (policy.timeoutMilliseconds && Clock::now() >= deadline) {
+            status = PollStatus::timedOut;
+            statistics.timeoutCount++;
+            break;
+        }
+
+        if (iterations < policy.spinCount) {
+            continue;
+        } else if (iterations < uint64_t(policy.spinCount) + policy.yieldCount) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(sleepMicroseconds));
+            statistics.sleepCount++;
+            sleepMicroseconds = std::min(std::max(1u, policy.maxSleepMicroseconds), sleepMicroseconds << 1);
+        }
+    }
+
+    statistics.pollCount++;
+    statistics.iterationCount += iterations;
+    statistics.maxIterations = std::max(statistics.maxIterations, iterations);
+    return status;
+}
+
+} // namespace aub_stream
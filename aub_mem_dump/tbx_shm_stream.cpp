@@ -12,6 +12,7 @@
 #include "tbx_sockets.h"
 #include "memcpy_s.h"
 #include "options.h"
+#include <atomic>
 #include <cassert>
 #include <sstream>
 #include <iostream>
@@ -55,11 +56,14 @@ bool TbxShmStream::init(TranslatePhysicalAddressToSystemMemoryFn fn) {
     assert(socket != nullptr);
 
     translatePhysicalAddressToSystemMemory = fn;
+    pollPolicy = getTbxPollPolicy();
 
     return socket->init(tbxServerIp, tbxServerPort, tbxFrontdoorMode);
 }
 
 void TbxShmStream::readContiguousPages(void *memory, size_t size, uint64_t physAddress, int addressSpace, int hint) {
+    // batched MMIO writes (e.g. submissions) must reach the simulator before results are read from shared memory
+    socket->flush();
     bool isLocalMemory = addressSpace == AddressSpaceValues::TraceLocal;
     void *p;
     size_t availableSize;
@@ -70,6 +74,7 @@ void TbxShmStream::readContiguousPages(void *memory, size_t size, uint64_t physA
 }
 
 void TbxShmStream::readDiscontiguousPages(void *memory, size_t size, const std::vector<PageInfo> &writeInfoTable) {
+    socket->flush();
     for (auto &entry : writeInfoTable) {
         void *p;
         size_t availableSize;
@@ -83,29 +88,39 @@ void TbxShmStream::readDiscontiguousPages(void *memory, size_t size, const std::
 }
 
 void TbxShmStream::registerPoll(uint32_t registerOffset, uint32_t mask, uint32_t desiredValue, bool pollNotEqual, uint32_t timeoutAction) {
-    bool matches = false;
-    do {
+    auto status = poll(pollPolicy, pollStatistics, [&]() {
         uint32_t value = 0;
         socket->readMMIO(registerOffset, &value);
 
-        matches = ((value & mask) == desiredValue);
-    } while (matches == pollNotEqual);
+        bool matches = ((value & mask) == desiredValue);
+        return matches != pollNotEqual ? PollStatus::matched : PollStatus::pending;
+    });
+
+    if (status == PollStatus::timedOut) {
+        handlePollTimeout("Register", registerOffset, timeoutAction);
+    }
 }
 
 void TbxShmStream::memoryPoll(const std::vector<PageInfo> &entries, uint32_t value, uint32_t compareMode) {
     assert(entries.size() == 1);
-    bool matches = false;
+    socket->flush();
+
+    void *p;
+    size_t availableSize;
+    translatePhysicalAddressToSystemMemory(entries[0].physicalAddress, entries[0].size, entries[0].isLocalMemory, p, availableSize);
 
-    do {
+    auto status = poll(pollPolicy, pollStatistics, [&]() {
         uint32_t readValue = 0;
-        void *p;
-        size_t availableSize;
-        translatePhysicalAddressToSystemMemory(entries[0].physicalAddress, entries[0].size, entries[0].isLocalMemory, p, availableSize);
         // read shared mem
+        std::atomic_thread_fence(std::memory_order_acquire);
         memcpy_s(&readValue, sizeof(readValue), p, sizeof(readValue));
 
-        matches = compareMemory(readValue, value, compareMode);
-    } while (!matches);
+        return compareMemory(readValue, value, compareMode) ? PollStatus::matched : PollStatus::pending;
+    });
+
+    if (status == PollStatus::timedOut) {
+        handlePollTimeout("Memory", entries[0].physicalAddress, CmdServicesMemTraceMemoryPoll::TimeoutActionValues::Abort);
+    }
 }
 
 void TbxShmStream::writeMMIO(uint32_t offset, uint32_t value, uint32_t mask) {
@@ -8,6 +8,7 @@
 #pragma once
 #include "aub_stream.h"
 #include "tbx_sockets.h"
+#include "poll_helper.h"
 #include "aubstream/shared_mem_info.h"
 #include "alloc_tools.h"
 #include <chrono>
@@ -57,6 +58,9 @@ struct TbxShmStream : public AubStream {
 
     void enableThrowOnError(bool enabled);
 
+    const PollStatistics &getPollStatistics() const { return pollStatistics; }
+    PollPolicy pollPolicy;
+
   protected:
     void readContiguousPages(void *memory, size_t size, uint64_t physAddress, int addressSpace, int hint);
     void readDiscontiguousPages(void *memory, size_t size, const std::vector<PageInfo> &writeInfoTable) override;
@@ -65,6 +69,8 @@ struct TbxShmStream : public AubStream {
     void writeDiscontiguousPages(const std::vector<PageEntryInfo> &writeInfoTable, int addressSpace, int hint) override;
     void memoryPoll(const std::vector<PageInfo> &entries, uint32_t value, uint32_t compareMode) override;
 
+    PollStatistics pollStatistics;
+
     std::chrono::time_point<std::chrono::steady_clock> lastTimeCheck{};
     virtual void checkSocketAlive();
 
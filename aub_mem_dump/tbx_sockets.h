@@ -37,6 +37,9 @@ class TbxSockets {
 
     virtual void enableThrowOnError(bool enabled) = 0;
 
+    // sends messages held back by write batching, needed before waiting on state changed by those writes
+    virtual bool flush() { return true; }
+
     static TbxSockets *create();
 };
 
@@ -6,6 +6,7 @@
  */
 
 #include "tbx_sockets_imp.h"
+#include "aub_mem_dump/metrics_registry.h"
 #include "aub_mem_dump/settings.h"
 #include <cassert>
 #include <iostream>
@@ -45,6 +46,7 @@ TbxSocketsImp::TbxSocketsImp(std::ostream &err)
 
 void TbxSocketsImp::close() {
     if (0 != m_socket) {
+        flush();
 #ifdef _WIN32
         ::shutdown(m_socket, 0x02 /*SD_BOTH*/);
 
@@ -66,13 +68,14 @@ bool TbxSocketsImp::stillConnected() {
     bool success;
     do {
         std::lock_guard<std::mutex> lock(socket_mutex);
+        ScopedOperationTimer timer(OperationType::socketRoundTrip);
         HAS_MSG cmd;
         memset(&cmd, 0, sizeof(cmd));
         cmd.hdr.msg_type = HAS_MARKER_REQ_TYPE;
         cmd.hdr.size = 0;
         cmd.hdr.trans_id = transID++;
 
-        success = sendWriteData(&cmd, sizeof(HAS_HDR));
+        success = flushSendBuffer(&cmd, sizeof(HAS_HDR));
         if (!success) {
             break;
         }
@@ -116,6 +119,9 @@ void TbxSocketsImp::logErrorInfo(const char *tag) {
 }
 
 bool TbxSocketsImp::init(const std::string &hostNameOrIp, uint16_t port, bool frontdoor) {
+    sendBufferSize = globalSettings->TbxSendBufferSizeKB.get() > 0 ? static_cast<size_t>(globalSettings->TbxSendBufferSizeKB.get()) * 1024 : 0;
+    sendBuffer.reserve(sendBufferSize);
+
     do {
 #ifdef _WIN32
         WSADATA wsaData;
@@ -264,6 +270,7 @@ bool TbxSocketsImp::readMMIO(uint32_t offset, uint32_t *data) {
 
     do {
         std::lock_guard<std::mutex> lock(socket_mutex);
+        ScopedOperationTimer timer(OperationType::socketRoundTrip, sizeof(uint32_t));
         HAS_MSG cmd;
         memset(&cmd, 0, sizeof(cmd));
         cmd.hdr.msg_type = HAS_MMIO_REQ_TYPE;
@@ -276,7 +283,7 @@ bool TbxSocketsImp::readMMIO(uint32_t offset, uint32_t *data) {
         cmd.u.mmio_req.msg_type = MSG_TYPE_MMIO;
         cmd.u.mmio_req.size = sizeof(uint32_t);
 
-        success = sendWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
+        success = flushSendBuffer(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
         if (!success) {
             break;
         }
@@ -314,7 +321,7 @@ bool TbxSocketsImp::writeMMIO(uint32_t offset, uint32_t value) {
     cmd.u.mmio_req.write = 1;
     cmd.u.mmio_req.size = sizeof(uint32_t);
 
-    return sendWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
+    return queueWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
 }
 
 bool TbxSocketsImp::writePCICFG(uint32_t bus, uint32_t device, uint32_t function, uint32_t offset, uint32_t value) {
@@ -332,7 +339,7 @@ bool TbxSocketsImp::writePCICFG(uint32_t bus, uint32_t device, uint32_t function
     cmd.u.pcicfg_req.write = 1;
     cmd.u.pcicfg_req.size = sizeof(uint32_t);
 
-    return sendWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
+    return queueWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
 }
 
 bool TbxSocketsImp::readPCICFG(uint32_t bus, uint32_t device, uint32_t function, uint32_t offset, uint32_t *data) {
@@ -350,7 +357,8 @@ bool TbxSocketsImp::readPCICFG(uint32_t bus, uint32_t device, uint32_t function,
         cmd.u.pcicfg_req.function = function;
         cmd.u.pcicfg_req.offset = offset;
         std::lock_guard<std::mutex> lock(socket_mutex);
-        success = sendWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
+        ScopedOperationTimer timer(OperationType::socketRoundTrip, sizeof(uint32_t));
+        success = flushSendBuffer(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
         if (!success) {
             break;
         }
@@ -394,7 +402,8 @@ bool TbxSocketsImp::readMemory(uint64_t addrOffset, void *data, size_t size, boo
     bool success;
     do {
         std::lock_guard<std::mutex> lock(socket_mutex);
-        success = sendWriteData(&cmd, sizeof(HAS_HDR) + sizeof(HAS_READ_DATA_REQ));
+        ScopedOperationTimer timer(OperationType::socketRoundTrip, size);
+        success = flushSendBuffer(&cmd, sizeof(HAS_HDR) + sizeof(HAS_READ_DATA_REQ));
         if (!success) {
             break;
         }
@@ -441,12 +450,12 @@ bool TbxSocketsImp::writeMemory(uint64_t physAddr, const void *data, size_t size
     bool success;
     do {
         std::lock_guard<std::mutex> lock(socket_mutex);
-        success = sendWriteData(&cmd, sizeof(HAS_HDR) + sizeof(HAS_WRITE_DATA_REQ));
+        success = queueWriteData(&cmd, sizeof(HAS_HDR) + sizeof(HAS_WRITE_DATA_REQ));
         if (!success) {
             break;
         }
 
-        success = sendWriteData(data, size);
+        success = queueWriteData(data, size);
         if (!success) {
             cerrStream << "Problem sending write data?" << std::endl;
             break;
@@ -467,7 +476,7 @@ bool TbxSocketsImp::writeGTT(uint32_t offset, uint64_t entry) {
     cmd.u.gtt64_req.data = static_cast<uint32_t>(entry & 0xffffffff);
     cmd.u.gtt64_req.data_h = static_cast<uint32_t>(entry >> 32);
     std::lock_guard<std::mutex> lock(socket_mutex);
-    return sendWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
+    return queueWriteData(&cmd, sizeof(HAS_HDR) + cmd.hdr.size);
 }
 
 bool TbxSocketsImp::sendWriteData(const void *buffer, size_t sizeInBytes) {
@@ -497,6 +506,50 @@ bool TbxSocketsImp::sendWriteData(const void *buffer, size_t sizeInBytes) {
     return true;
 }
 
+bool TbxSocketsImp::queueWriteData(const void *buffer, size_t sizeInBytes) {
+    if (sendBufferSize == 0) {
+        return sendWriteData(buffer, sizeInBytes);
+    }
+    if (inErrorState) {
+        return false;
+    }
+
+    if (sendBuffer.size() + sizeInBytes > sendBufferSize) {
+        if (!flushSendBuffer()) {
+            return false;
+        }
+        // large payloads go out directly, right after the messages that preceded them
+        if (sizeInBytes >= sendBufferSize) {
+            return sendWriteData(buffer, sizeInBytes);
+        }
+    }
+    auto dataBuffer = reinterpret_cast<const char *>(buffer);
+    sendBuffer.insert(sendBuffer.end(), dataBuffer, dataBuffer + sizeInBytes);
+    return true;
+}
+
+bool TbxSocketsImp::flushSendBuffer(const void *payload, size_t payloadSize) {
+    if (sendBuffer.empty()) {
+        return payloadSize == 0 || sendWriteData(payload, payloadSize);
+    }
+
+    // a payload fitting in the buffer (e.g. a read request) leaves in the same send as the pending messages
+    if (payloadSize && sendBuffer.size() + payloadSize <= sendBufferSize) {
+        auto dataBuffer = reinterpret_cast<const char *>(payload);
+        sendBuffer.insert(sendBuffer.end(), dataBuffer, dataBuffer + payloadSize);
+        payloadSize = 0;
+    }
+
+    bool success = sendWriteData(sendBuffer.data(), sendBuffer.size());
+    sendBuffer.clear();
+    return success && (payloadSize == 0 || sendWriteData(payload, payloadSize));
+}
+
+bool TbxSocketsImp::flush() {
+    std::lock_guard<std::mutex> lock(socket_mutex);
+    return flushSendBuffer();
+}
+
 bool TbxSocketsImp::getResponseData(void *buffer, size_t sizeInBytes) {
     size_t totalRecv = 0;
     auto dataBuffer = reinterpret_cast<char *>(buffer);
@@ -548,7 +601,8 @@ bool TbxSocketsImp::readMemoryExt(uint64_t addrOffset, void *data, size_t size,
     bool success;
     do {
         std::lock_guard<std::mutex> lock(socket_mutex);
-        success = sendWriteData(&cmd, sizeof(HAS_HDR) + sizeof(HAS_READ_DATA_EXT_REQ));
+        ScopedOperationTimer timer(OperationType::socketRoundTrip, size);
+        success = flushSendBuffer(&cmd, sizeof(HAS_HDR) + sizeof(HAS_READ_DATA_EXT_REQ));
         if (!success) {
             break;
         }
@@ -595,12 +649,12 @@ bool TbxSocketsImp::writeMemoryExt(uint64_t physAddr, const void *data, size_t s
     bool success;
     do {
         std::lock_guard<std::mutex> lock(socket_mutex);
-        success = sendWriteData(&cmd, sizeof(HAS_HDR) + sizeof(HAS_WRITE_DATA_EXT_REQ));
+        success = queueWriteData(&cmd, sizeof(HAS_HDR) + sizeof(HAS_WRITE_DATA_EXT_REQ));
         if (!success) {
             break;
         }
 
-        success = sendWriteData(data, size);
+        success = queueWriteData(data, size);
         if (!success) {
             cerrStream << "Problem sending write data?" << std::endl;
             break;
@@ -9,6 +9,7 @@
 #include "tbx_sockets.h"
 #include <iostream>
 #include <mutex>
+#include <vector>
 
 #ifdef _WIN32
 #ifndef _WIN32_LEAN_AND_MEAN
@@ -45,6 +46,7 @@ class TbxSocketsImp : public TbxSockets {
     bool writePCICFG(uint32_t bus, uint32_t device, uint32_t function, uint32_t offset, uint32_t data) override;
 
     void enableThrowOnError(bool enabled) override;
+    bool flush() override;
 
   protected:
     std::ostream &cerrStream;
@@ -52,8 +54,10 @@ class TbxSocketsImp : public TbxSockets {
 
     bool connectToServer(const std::string &hostNameOrIp, uint16_t port);
     bool checkServerConfig(bool frontdoor);
-    bool sendWriteData(const void *buffer, size_t sizeInBytes);
-    bool getResponseData(void *buffer, size_t sizeInBytes);
+    virtual bool sendWriteData(const void *buffer, size_t sizeInBytes);
+    bool queueWriteData(const void *buffer, size_t sizeInBytes);
+    bool flushSendBuffer(const void *payload = nullptr, size_t payloadSize = 0);
+    virtual bool getResponseData(void *buffer, size_t sizeInBytes);
 
     inline uint32_t getNextTransID() { return transID++; }
 
@@ -68,6 +72,9 @@ class TbxSocketsImp : public TbxSockets {
     std::mutex socket_mutex{};
 
     bool throwOnError = false;
+
+    std::vector<char> sendBuffer; // fire-and-forget messages batched until a request needs a response
+    size_t sendBufferSize = 0;
 };
 
 } // namespace aub_stream
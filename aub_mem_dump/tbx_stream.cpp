@@ -44,6 +44,7 @@ void TbxStream::reserveContiguousPages(const std::vector<uint64_t> &entries) {
 bool TbxStream::init(int stepping, const GpuDescriptor &gpu) {
     socket = TbxSockets::create();
     assert(socket != nullptr);
+    pollPolicy = getTbxPollPolicy();
     return socket->init(tbxServerIp, tbxServerPort, tbxFrontdoorMode);
 }
 
@@ -61,37 +62,39 @@ void TbxStream::readDiscontiguousPages(void *memory, size_t size, const std::vec
 
 void TbxStream::memoryPoll(const std::vector<PageInfo> &entries, uint32_t value, uint32_t compareMode) {
     assert(entries.size() == 1);
-    bool matches = false;
 
-    do {
+    auto status = poll(pollPolicy, pollStatistics, [&]() {
         uint32_t readValue = 0;
-        auto status = socket->readMemory(entries[0].physicalAddress, &readValue, sizeof(readValue), entries[0].isLocalMemory);
-        if (!status) {
-            break;
+        if (!socket->readMemory(entries[0].physicalAddress, &readValue, sizeof(readValue), entries[0].isLocalMemory)) {
+            return PollStatus::failed;
         }
+        return compareMemory(readValue, value, compareMode) ? PollStatus::matched : PollStatus::pending;
+    });
 
-        matches = compareMemory(readValue, value, compareMode);
-    } while (!matches);
+    if (status == PollStatus::timedOut) {
+        handlePollTimeout("Memory", entries[0].physicalAddress, CmdServicesMemTraceMemoryPoll::TimeoutActionValues::Abort);
+    }
 }
 
 void TbxStream::registerPoll(uint32_t registerOffset, uint32_t mask, uint32_t desiredValue, bool pollNotEqual, uint32_t timeoutAction) {
-    bool matches = false;
-    do {
+    auto status = poll(pollPolicy, pollStatistics, [&]() {
         uint32_t value = 0;
-        auto status = socket->readMMIO(registerOffset, &value);
-
-        if (!status) {
-            break;
+        if (!socket->readMMIO(registerOffset, &value)) {
+            return PollStatus::failed;
         }
-
-        matches = ((value & mask) == desiredValue);
         if (value & 1) {
-            break;
+            return PollStatus::matched;
         }
 
         PRINT_LOG_VERBOSE(" EXECLIST_STATUS = %d \n", value);
 
-    } while (matches == pollNotEqual);
+        bool matches = ((value & mask) == desiredValue);
+        return matches != pollNotEqual ? PollStatus::matched : PollStatus::pending;
+    });
+
+    if (status == PollStatus::timedOut) {
+        handlePollTimeout("Register", registerOffset, timeoutAction);
+    }
 }
 
 void TbxStream::writeMMIO(uint32_t offset, uint32_t value, uint32_t mask) {
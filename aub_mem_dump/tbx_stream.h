@@ -8,6 +8,7 @@
 #pragma once
 #include "aub_stream.h"
 #include "tbx_sockets.h"
+#include "poll_helper.h"
 
 namespace aub_stream {
 struct AubTbxStream;
@@ -34,6 +35,9 @@ struct TbxStream : public AubStream {
     TbxSockets *socket = nullptr;
     friend AubTbxStream;
 
+    const PollStatistics &getPollStatistics() const { return pollStatistics; }
+    PollPolicy pollPolicy;
+
   protected:
     void writeGttPages(GGTT *ggtt, const std::vector<PageEntryInfo> &writeInfoTable) override;
 
@@ -43,6 +47,8 @@ struct TbxStream : public AubStream {
     void writeDiscontiguousPages(const void *memory, size_t size, const std::vector<PageInfo> &writeInfoTable, int hint) override;
     void writeDiscontiguousPages(const std::vector<PageEntryInfo> &writeInfoTable, int addressSpace, int hint) override;
     void memoryPoll(const std::vector<PageInfo> &entries, uint32_t value, uint32_t compareMode) override;
+
+    PollStatistics pollStatistics;
 };
 
 } // namespace aub_stream
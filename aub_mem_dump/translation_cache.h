@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace aub_stream {
+
+// Direct-mapped cache of PPGTT translations, keyed by 4KB virtual page. Each entry holds the physical page
+// and page size of the mapping (4KB, 64KB or 2MB) that covers the virtual page, so a hit answers a lookup
+// without descending the page table tree.
+class TranslationCache {
+  public:
+    static constexpr size_t entryCount = 64;
+    // Invalidations are widened to this alignment, a remapped or freed 2MB page covers 512 virtual pages
+    static constexpr uint64_t invalidationAlignment = 2 * 1024 * 1024;
+
+    struct Translation {
+        uint64_t physicalAddress; // of the mapped page, not of the 4KB virtual page
+        size_t pageSize;
+        bool isLocalMemory;
+    };
+
+    bool lookup(uint64_t gfxAddress, Translation &translation) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto &entry = entries[getSlot(gfxAddress)];
+        if (entry.tag != getTag(gfxAddress)) {
+            return false;
+        }
+        translation = entry.translation;
+        return true;
+    }
+
+    void insert(uint64_t gfxAddress, const Translation &translation) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[getSlot(gfxAddress)] = {getTag(gfxAddress), translation};
+    }
+
+    void invalidate(uint64_t gfxAddress, size_t size) {
+        const uint64_t first = getTag(gfxAddress & ~(invalidationAlignment - 1));
+        const uint64_t last = getTag(((gfxAddress + size + invalidationAlignment - 1) & ~(invalidationAlignment - 1)) - 1);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &entry : entries) {
+            if (entry.tag >= first && entry.tag <= last) {
+                entry.tag = invalidTag;
+            }
+        }
+    }
+
+  protected:
+    static constexpr uint64_t invalidTag = 0;
+
+    struct Entry {
+        uint64_t tag = invalidTag;
+        Translation translation = {};
+    };
+
+    // Virtual page number plus one, so that zero marks an empty entry
+    static uint64_t getTag(uint64_t gfxAddress) { return (gfxAddress >> 12) + 1; }
+    static size_t getSlot(uint64_t gfxAddress) { return static_cast<size_t>(gfxAddress >> 12) % entryCount; }
+
+    std::array<Entry, entryCount> entries = {};
+    std::mutex mutex;
+};
+
+} // namespace aub_stream
@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include "allocation_params.h"
+#include "operation_metrics.h"
 #include "page_info.h"
 #include "shared_mem_info.h"
 #include "physical_allocation_info.h"
@@ -80,6 +81,9 @@ class AubManager {
     virtual void setCCSMode(uint32_t ccsCount) {}
     virtual void closeSocket(void) {}
     virtual HardwareContext *createHardwareContext3(const HardwareContextParamsHeader *params) { return nullptr; }
+    virtual void flush() {}
+    virtual std::vector<OperationMetrics> getOperationMetrics() { return {}; }
+    virtual void resetOperationMetrics() {}
 };
 
 } // namespace aub_stream
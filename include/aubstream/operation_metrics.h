@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+namespace aub_stream {
+
+struct OperationMetrics {
+    static constexpr uint32_t histogramBucketCount = 32;
+
+    const char *name;
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t totalNanoseconds;
+    uint64_t maxNanoseconds;
+    // bucket i counts calls that took [2^i, 2^(i+1)) ns, the first bucket also counts 0 ns and the last one has no upper bound
+    uint64_t latencyHistogram[histogramBucketCount];
+};
+
+static_assert(std::is_standard_layout_v<OperationMetrics> && std::is_trivial_v<OperationMetrics> && std::is_trivially_copyable_v<OperationMetrics>, "OperationMetrics is not POD type");
+
+} // namespace aub_stream
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/benchmark_helpers.h"
+#include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/page_table.h"
+#include "aub_mem_dump/page_table_walker.h"
+#include "aubstream/hint_values.h"
+
+#include <numeric>
+#include <vector>
+
+using namespace aub_stream;
+
+namespace {
+
+struct BenchmarkAubFileStream : public AubFileStream {
+    using AubFileStream::writeDiscontiguousPages;
+};
+
+// Frees a mapped range of pageSize pages (Arg), including the zeroed entries written to the AUB sink.
+void BM_AubStreamFreeMemory(benchmark::State &state) {
+    constexpr uint64_t gfxAddress = 0x100000000ull;
+    constexpr size_t size = 16 * MB;
+    const size_t pageSize = static_cast<size_t>(state.range(0));
+    const uint32_t memoryBank = pageSize == Page2MB::pageSize2MB ? MEMORY_BANK_0 : MEMORY_BANK_SYSTEM;
+
+    auto gpu = createBenchmarkGpu();
+    AubFileStream stream;
+    AubSink sink(stream, *gpu);
+    PhysicalAddressAllocatorSimple allocator(1, 4ull * GB, true);
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            PageTableWalker walker;
+            walker.walkMemory(&ppgtt, {gfxAddress, nullptr, size, memoryBank, 0, pageSize}, PageTableWalker::WalkMode::Reserve, nullptr);
+        }
+        state.ResumeTiming();
+
+        stream.freeMemory(&ppgtt, gfxAddress, size);
+        sink.addBytesWritten(state, (size / pageSize) * sizeof(uint64_t));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (size / pageSize)));
+}
+BENCHMARK(BM_AubStreamFreeMemory)->ArgName("pageSize")->Arg(4096)->Arg(65536)->Arg(Page2MB::pageSize2MB)->Unit(benchmark::kMicrosecond);
+
+// Uploads Arg 4KB pages to an already mapped range, the steady state of a driver rewriting its buffers.
+// allocs_per_call counts heap allocations made by each writeMemory.
+void BM_AubStreamWriteMemory(benchmark::State &state) {
+    constexpr uint64_t gfxAddress = 0x100000000ull;
+    const size_t size = static_cast<size_t>(state.range(0)) * 4096;
+
+    auto gpu = createBenchmarkGpu();
+    AubFileStream stream;
+    AubSink sink(stream, *gpu);
+    PhysicalAddressAllocatorSimple allocator(1, 4ull * GB, true);
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+
+    std::vector<uint32_t> memory(size / sizeof(uint32_t));
+    std::iota(memory.begin(), memory.end(), 0u);
+    const AllocationParams allocationParams(gfxAddress, memory.data(), size, MEMORY_BANK_SYSTEM, DataTypeHintValues::TraceNotype, 4096);
+    stream.writeMemory(&ppgtt, allocationParams);
+
+    const auto allocationsBefore = getAllocationCount();
+    for (auto _ : state) {
+        stream.writeMemory(&ppgtt, allocationParams);
+        sink.addBytesWritten(state, size);
+    }
+    state.counters["allocs_per_call"] = benchmark::Counter(static_cast<double>(getAllocationCount() - allocationsBefore), benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_AubStreamWriteMemory)->ArgName("pages")->Arg(1)->Arg(16)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+// Writes Arg 4KB pages scattered over physical memory as discontiguous memory write records.
+void BM_AubFileStreamWriteDiscontiguousPages(benchmark::State &state) {
+    const size_t pageCount = static_cast<size_t>(state.range(0));
+    const size_t size = pageCount * 4096;
+
+    auto gpu = createBenchmarkGpu();
+    BenchmarkAubFileStream stream;
+    AubSink sink(stream, *gpu);
+
+    std::vector<uint32_t> memory(size / sizeof(uint32_t));
+    std::iota(memory.begin(), memory.end(), 0u);
+
+    std::vector<PageInfo> writeInfoTable(pageCount);
+    for (size_t i = 0; i < pageCount; i++) {
+        writeInfoTable[i] = {0x10000000ull + i * 2 * 4096, 4096, false, MEMORY_BANK_SYSTEM};
+    }
+
+    for (auto _ : state) {
+        stream.writeDiscontiguousPages(memory.data(), size, writeInfoTable, DataTypeHintValues::TraceNotype);
+        sink.addBytesWritten(state, size);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_AubFileStreamWriteDiscontiguousPages)->ArgName("pages")->Arg(2)->Arg(16)->Arg(256)->Arg(4096);
+
+// Writes Arg page table entries scattered over physical memory, as done after every page table walk.
+void BM_AubFileStreamWriteDiscontiguousPageEntries(benchmark::State &state) {
+    const size_t entryCount = static_cast<size_t>(state.range(0));
+
+    auto gpu = createBenchmarkGpu();
+    BenchmarkAubFileStream stream;
+    AubSink sink(stream, *gpu);
+
+    std::vector<PageEntryInfo> writeInfoTable(entryCount);
+    for (size_t i = 0; i < entryCount; i++) {
+        writeInfoTable[i] = {0x10000000ull + i * 4096, 0x20000000ull + i * 4096 + 3};
+    }
+
+    for (auto _ : state) {
+        stream.writeDiscontiguousPages(writeInfoTable, AddressSpaceValues::TraceNonlocal, DataTypeHintValues::TracePpgttLevel1);
+        sink.addBytesWritten(state, entryCount * sizeof(uint64_t));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * entryCount));
+}
+BENCHMARK(BM_AubFileStreamWriteDiscontiguousPageEntries)->ArgName("entries")->Arg(2)->Arg(16)->Arg(512);
+
+} // namespace
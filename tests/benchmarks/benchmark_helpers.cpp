@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/benchmark_helpers.h"
+#include "aub_mem_dump/family_mapper.h"
+#include "aub_mem_dump/memory_banks.h"
+#include "aubstream/aubstream.h"
+#include "aubstream/product_family.h"
+#include "aubstream/stepping_values.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sys/stat.h>
+
+namespace {
+std::atomic<size_t> allocationCount{0};
+} // namespace
+
+void *operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
+
+namespace aub_stream {
+
+std::string aubSinkFileName = "/dev/null";
+
+size_t getAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+std::unique_ptr<Gpu> createBenchmarkGpu() {
+    return getGpu(ProductFamily::Cri)();
+}
+
+AubManagerOptions createBenchmarkManagerOptions(uint32_t mode) {
+    AubManagerOptions options;
+    options.version = 1;
+    options.productFamily = static_cast<uint32_t>(ProductFamily::Cri);
+    options.devicesCount = 1;
+    options.memoryBankSize = 4ull * GB;
+    options.stepping = SteppingValues::A;
+    options.localMemorySupported = true;
+    options.mode = mode;
+    options.gpuAddressSpace = (1ull << 48) - 1;
+    return options;
+}
+
+AubSink::AubSink(AubFileStream &stream, const Gpu &gpu) : stream(stream) {
+    struct stat fileStatus = {};
+    isRegularFile = ::stat(aubSinkFileName.c_str(), &fileStatus) != 0 || S_ISREG(fileStatus.st_mode);
+
+    stream.open(aubSinkFileName.c_str());
+    stream.init(SteppingValues::A, gpu);
+}
+
+AubSink::~AubSink() {
+    stream.close();
+}
+
+void AubSink::addBytesWritten(benchmark::State &state, size_t bytes) {
+    bytesWritten += bytes;
+    if (!isRegularFile || bytesWritten < maxBytesBeforeReopen) {
+        return;
+    }
+
+    state.PauseTiming();
+    stream.close();
+    stream.open(aubSinkFileName.c_str());
+    bytesWritten = 0;
+    state.ResumeTiming();
+}
+
+} // namespace aub_stream
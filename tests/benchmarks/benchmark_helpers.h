@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "aub_mem_dump/aub_file_stream.h"
+#include "aub_mem_dump/gpu.h"
+#include "aubstream/aub_manager.h"
+
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <string>
+
+namespace aub_stream {
+
+// File AUB output is written to, /dev/null by default. Set with --aub_sink=<file>, e.g. a file on tmpfs.
+extern std::string aubSinkFileName;
+
+// Product used by all benchmarks, the only one supporting 4KB, 64KB and 2MB pages.
+std::unique_ptr<Gpu> createBenchmarkGpu();
+AubManagerOptions createBenchmarkManagerOptions(uint32_t mode);
+
+// Number of operator new calls made by the benchmark process so far, counted by a replacement operator new.
+size_t getAllocationCount();
+
+// Keeps a regular sink file from filling tmpfs: once enough bytes are written the file is reopened
+// (truncated) with the benchmark timer paused. Does nothing for character devices like /dev/null.
+class AubSink {
+  public:
+    static constexpr size_t maxBytesBeforeReopen = 256 * 1024 * 1024;
+
+    AubSink(AubFileStream &stream, const Gpu &gpu);
+    ~AubSink();
+
+    void addBytesWritten(benchmark::State &state, size_t bytes);
+
+  protected:
+    AubFileStream &stream;
+    size_t bytesWritten = 0;
+    bool isRegularFile = false;
+};
+
+} // namespace aub_stream
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/benchmark_helpers.h"
+#include "tests/benchmarks/tbx_stub_server.h"
+#include "aub_mem_dump/memory_banks.h"
+#include "aubstream/aubstream.h"
+#include "aubstream/engine_node.h"
+#include "aubstream/hardware_context.h"
+#include "aubstream/hint_values.h"
+
+using namespace aub_stream;
+
+namespace {
+
+// Submits the same batch buffer over and over, Arg selects aub_stream::mode::aubFile (sink file) or mode::tbx (stub server).
+void BM_HardwareContextSubmitBatchBuffer(benchmark::State &state) {
+    constexpr uint64_t batchBufferAddress = 0x100000;
+    const uint32_t streamMode = static_cast<uint32_t>(state.range(0));
+
+    TbxStubServer server;
+    if (streamMode == mode::tbx) {
+        if (!server.start()) {
+            state.SkipWithError("Cannot start TBX stub server");
+            return;
+        }
+        setTbxServerIp("127.0.0.1");
+        setTbxServerPort(server.getPort());
+    }
+
+    std::unique_ptr<AubManager> manager(AubManager::create(createBenchmarkManagerOptions(streamMode)));
+    if (!manager) {
+        state.SkipWithError("Cannot create AubManager");
+        return;
+    }
+    if (streamMode == mode::aubFile) {
+        manager->open(aubSinkFileName);
+    }
+
+    auto context = manager->createHardwareContext(0, ENGINE_CCS, 0);
+    context->initialize();
+
+    const uint32_t batchBuffer[] = {0x00000000, 0x05000000}; // MI_NOOP, MI_BATCH_BUFFER_END
+    context->writeMemory(batchBufferAddress, batchBuffer, sizeof(batchBuffer), MEMORY_BANK_0, DataTypeHintValues::TraceBatchBufferPrimary, 65536);
+
+    for (auto _ : state) {
+        context->submitBatchBuffer(batchBufferAddress, false);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+
+    manager->releaseHardwareContext(context);
+    manager->close();
+    manager.reset();
+    state.counters["tbxMessages"] = static_cast<double>(server.getMessageCount());
+}
+BENCHMARK(BM_HardwareContextSubmitBatchBuffer)->ArgName("mode")->Arg(mode::aubFile)->Arg(mode::tbx);
+
+} // namespace
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/benchmark_helpers.h"
+#include "aub_mem_dump/settings.h"
+
+#include <cstring>
+
+using namespace aub_stream;
+
+int main(int argc, char **argv) {
+    std::unique_ptr<Settings> settings = std::make_unique<Settings>();
+    globalSettings = settings.get();
+    globalSettings->TbxConnectionDelayInSeconds.set(0);
+
+    constexpr const char *sinkArgument = "--aub_sink=";
+    int remainingArgc = 0;
+    for (int i = 0; i < argc; ++i) {
+        if (strncmp(argv[i], sinkArgument, strlen(sinkArgument)) == 0) {
+            aubSinkFileName = argv[i] + strlen(sinkArgument);
+            continue;
+        }
+        argv[remainingArgc++] = argv[i];
+    }
+    argc = remainingArgc;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
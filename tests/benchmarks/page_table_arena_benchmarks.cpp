@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/benchmark_helpers.h"
+#include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/page_table.h"
+#include "aub_mem_dump/page_table_pml5.h"
+#include "aub_mem_dump/page_table_walker.h"
+
+#include <optional>
+
+using namespace aub_stream;
+
+namespace {
+
+constexpr uint64_t mappedGfxAddress = 0x100000000ull;
+
+// Args: {sizeGB, pageSize}
+void mappingArguments(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgNames({"sizeGB", "pageSize"});
+    for (int64_t sizeGB : {1, 4, 16}) {
+        for (int64_t pageSize : {4096, 65536}) {
+            benchmark->Args({sizeGB, pageSize});
+        }
+    }
+}
+
+struct MappingFixture {
+    MappingFixture(benchmark::State &state) : gpu(createBenchmarkGpu()),
+                                              size(static_cast<size_t>(state.range(0)) * GB),
+                                              pageSize(static_cast<size_t>(state.range(1))) {
+    }
+
+    void map() {
+        allocator = std::make_unique<PhysicalAddressAllocatorSimple>();
+        ppgtt = std::make_unique<PML5>(*gpu, allocator.get(), MEMORY_BANK_SYSTEM);
+        PageTableWalker walker;
+        walker.walkMemory(ppgtt.get(), {mappedGfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, pageSize}, PageTableWalker::WalkMode::Reserve, nullptr);
+    }
+
+    void setCounters(benchmark::State &state) {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (size / pageSize)));
+        state.counters["nodes"] = static_cast<double>(ppgttNodeCount);
+    }
+
+    std::unique_ptr<Gpu> gpu;
+    size_t size;
+    size_t pageSize;
+    size_t ppgttNodeCount = 0;
+    std::unique_ptr<PhysicalAddressAllocatorSimple> allocator;
+    std::unique_ptr<PageTable> ppgtt;
+};
+
+// Maps a multi-GB range into a new PPGTT, allocating all of its page table nodes.
+void BM_PageTableArenaMapRange(benchmark::State &state) {
+    MappingFixture fixture(state);
+
+    for (auto _ : state) {
+        fixture.map();
+
+        state.PauseTiming();
+        fixture.ppgttNodeCount = fixture.ppgtt->getArena().getLiveNodeCount();
+        fixture.ppgtt.reset();
+        fixture.allocator.reset();
+        state.ResumeTiming();
+    }
+    fixture.setCounters(state);
+}
+BENCHMARK(BM_PageTableArenaMapRange)->Apply(mappingArguments)->Unit(benchmark::kMillisecond);
+
+// Destroys a PPGTT with a multi-GB range mapped, the teardown done when an AubManager is released.
+void BM_PageTableArenaTeardown(benchmark::State &state) {
+    MappingFixture fixture(state);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        fixture.map();
+        fixture.ppgttNodeCount = fixture.ppgtt->getArena().getLiveNodeCount();
+        state.ResumeTiming();
+
+        fixture.ppgtt.reset();
+
+        state.PauseTiming();
+        fixture.allocator.reset();
+        state.ResumeTiming();
+    }
+    fixture.setCounters(state);
+}
+BENCHMARK(BM_PageTableArenaTeardown)->Apply(mappingArguments)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/benchmark_helpers.h"
+#include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/page_table.h"
+#include "aub_mem_dump/page_table_pml5.h"
+#include "aub_mem_dump/page_table_walker.h"
+#include "aub_mem_dump/settings.h"
+
+#include <optional>
+
+using namespace aub_stream;
+
+namespace {
+
+constexpr uint64_t walkedGfxAddress = 0x100000000ull;
+constexpr size_t walkedSize = 64 * MB;
+
+// Args: {pageSize, levels, ps64}. PS64 is only applied to 4KB pages of 5-level tables, so it is not varied elsewhere.
+void walkMemoryArguments(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgNames({"pageSize", "levels", "ps64"});
+    for (int64_t levels : {4, 5}) {
+        for (int64_t pageSize : {4096, 65536, static_cast<int>(Page2MB::pageSize2MB)}) {
+            benchmark->Args({pageSize, levels, 1});
+            if (pageSize == 4096 && levels == 5) {
+                benchmark->Args({pageSize, levels, 0});
+            }
+        }
+    }
+}
+
+struct WalkMemoryFixture {
+    WalkMemoryFixture(benchmark::State &state) : gpu(createBenchmarkGpu()),
+                                                 pageSize(static_cast<size_t>(state.range(0))),
+                                                 levels(static_cast<uint32_t>(state.range(1))),
+                                                 ps64Backup(globalSettings->EnablePs64.get()) {
+        globalSettings->EnablePs64.set(state.range(2) != 0);
+        // 2MB pages are supported in local memory only
+        memoryBank = pageSize == Page2MB::pageSize2MB ? MEMORY_BANK_0 : MEMORY_BANK_SYSTEM;
+    }
+
+    ~WalkMemoryFixture() {
+        globalSettings->EnablePs64.set(ps64Backup);
+    }
+
+    void createPageTables() {
+        allocator = std::make_unique<PhysicalAddressAllocatorSimple>(1, 4ull * GB, true);
+        if (levels == 5) {
+            ppgtt = std::make_unique<PML5>(*gpu, allocator.get(), MEMORY_BANK_SYSTEM);
+        } else {
+            ppgtt = std::make_unique<PML4>(*gpu, allocator.get(), MEMORY_BANK_SYSTEM);
+        }
+    }
+
+    void destroyPageTables() {
+        ppgtt.reset();
+        allocator.reset();
+    }
+
+    void walk(PageTableWalker &walker) {
+        walker.walkMemory(ppgtt.get(), {walkedGfxAddress, nullptr, walkedSize, memoryBank, 0, pageSize}, PageTableWalker::WalkMode::Reserve, nullptr);
+    }
+
+    void setCounters(benchmark::State &state) {
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * walkedSize));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (walkedSize / pageSize)));
+    }
+
+    std::unique_ptr<Gpu> gpu;
+    size_t pageSize;
+    uint32_t levels;
+    uint32_t memoryBank;
+    bool ps64Backup;
+    std::unique_ptr<PhysicalAddressAllocatorSimple> allocator;
+    std::unique_ptr<PageTable> ppgtt;
+};
+
+// Builds page tables for an unmapped range, the cost of the first write of a new allocation.
+void BM_PageTableWalkerWalkMemory(benchmark::State &state) {
+    WalkMemoryFixture fixture(state);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        fixture.createPageTables();
+        std::optional<PageTableWalker> walker(std::in_place);
+        state.ResumeTiming();
+
+        fixture.walk(*walker);
+
+        state.PauseTiming();
+        walker.reset();
+        fixture.destroyPageTables();
+        state.ResumeTiming();
+    }
+    fixture.setCounters(state);
+}
+BENCHMARK(BM_PageTableWalkerWalkMemory)->Apply(walkMemoryArguments)->Unit(benchmark::kMillisecond);
+
+// Walks a range whose page tables already exist, the cost of rewriting an allocation.
+void BM_PageTableWalkerWalkMappedMemory(benchmark::State &state) {
+    WalkMemoryFixture fixture(state);
+    fixture.createPageTables();
+    {
+        PageTableWalker walker;
+        fixture.walk(walker);
+    }
+
+    for (auto _ : state) {
+        PageTableWalker walker;
+        fixture.walk(walker);
+        benchmark::DoNotOptimize(walker.entries.data());
+    }
+    fixture.setCounters(state);
+    fixture.destroyPageTables();
+}
+BENCHMARK(BM_PageTableWalkerWalkMappedMemory)->Apply(walkMemoryArguments)->Unit(benchmark::kMillisecond);
+
+// Rewalks a range large enough to be split across PageTableWalkThreads threads.
+void BM_PageTableWalkerWalkMappedMemoryThreads(benchmark::State &state) {
+    constexpr size_t size = 4 * PageTableWalker::parallelWalkMinSize;
+    const auto threadsBackup = globalSettings->PageTableWalkThreads.get();
+    globalSettings->PageTableWalkThreads.set(static_cast<int>(state.range(0)));
+
+    auto gpu = createBenchmarkGpu();
+    PhysicalAddressAllocatorSimple allocator(1, 4ull * GB, true);
+    PML5 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    const AllocationParams allocationParams = {walkedGfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096};
+    {
+        PageTableWalker walker;
+        walker.walkMemory(&ppgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr);
+        for (const auto &levelNodes : walker.pendingNodes)
+            for (auto *node : levelNodes)
+                node->setPendingWrite(false);
+        for (auto *leaf : walker.pendingLeaves)
+            leaf->setPendingWrite(false);
+    }
+
+    for (auto _ : state) {
+        PageTableWalker walker;
+        walker.walkMemory(&ppgtt, allocationParams, PageTableWalker::WalkMode::Expect, nullptr);
+        benchmark::DoNotOptimize(walker.entries.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (size / 4096)));
+    globalSettings->PageTableWalkThreads.set(threadsBackup);
+}
+BENCHMARK(BM_PageTableWalkerWalkMappedMemoryThreads)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond);
+
+// Maps (mapped:0) or rewalks (mapped:1) a GGTT range the size of a few rings and context images.
+void BM_PageTableWalkerWalkGgtt(benchmark::State &state) {
+    constexpr uint64_t gfxAddress = 0x100000;
+    constexpr size_t size = 1 * MB;
+    const auto pageSize = static_cast<size_t>(state.range(0));
+    const bool mapped = state.range(1) != 0;
+
+    auto gpu = createBenchmarkGpu();
+    std::optional<PhysicalAddressAllocatorSimple> allocator(std::in_place);
+    std::optional<GGTT> ggtt(std::in_place, *gpu, &*allocator, MEMORY_BANK_SYSTEM);
+    if (mapped) {
+        PageTableWalker walker;
+        walker.walkMemory(&*ggtt, gfxAddress, size, MEMORY_BANK_SYSTEM, pageSize, PageTableWalker::WalkMode::Reserve, nullptr);
+    }
+
+    for (auto _ : state) {
+        if (!mapped) {
+            state.PauseTiming();
+            ggtt.reset();
+            allocator.emplace();
+            ggtt.emplace(*gpu, &*allocator, MEMORY_BANK_SYSTEM);
+            state.ResumeTiming();
+        }
+        PageTableWalker walker;
+        walker.walkMemory(&*ggtt, gfxAddress, size, MEMORY_BANK_SYSTEM, pageSize, PageTableWalker::WalkMode::Reserve, nullptr);
+        benchmark::DoNotOptimize(walker.entries.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (size / pageSize)));
+}
+BENCHMARK(BM_PageTableWalkerWalkGgtt)->ArgNames({"pageSize", "mapped"})->ArgsProduct({{4096, 65536}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/benchmark_helpers.h"
+#include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/page_table.h"
+#include "aub_mem_dump/physical_address_allocator.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace aub_stream;
+
+namespace {
+
+struct BenchmarkSimpleAllocator : public SimpleAllocator<uint64_t> {
+    using SimpleAllocator<uint64_t>::SimpleAllocator;
+    using SimpleAllocator<uint64_t>::nextAddress;
+};
+
+// Mostly 4KB pages, some 64KB pages and an occasional 2MB page, each aligned to its size
+size_t pickChurnSize(std::mt19937 &random) {
+    auto pick = random() % 20;
+    return pick < 14 ? 4096 : (pick < 19 ? 65536 : Page2MB::pageSize2MB);
+}
+
+// Frees a random one of Arg live allocations and allocates a new one in its place, as a driver recycling buffers
+// and page tables does. addressSpaceMB is how far nextAddress grew while the live set stayed the same size.
+void BM_SimpleAllocatorChurn(benchmark::State &state) {
+    struct Allocation {
+        uint64_t address;
+        size_t size;
+    };
+    constexpr uint64_t firstAddress = 0x1000;
+    const size_t liveCount = static_cast<size_t>(state.range(0));
+
+    BenchmarkSimpleAllocator allocator(firstAddress);
+    std::mt19937 random(0);
+    std::vector<Allocation> live(liveCount);
+    for (auto &allocation : live) {
+        allocation.size = pickChurnSize(random);
+        allocation.address = allocator.alignedAlloc(allocation.size, allocation.size);
+    }
+    const auto initialAddressSpace = allocator.nextAddress - firstAddress;
+
+    for (auto _ : state) {
+        auto &allocation = live[random() % liveCount];
+        allocator.alignedFree(allocation.address);
+        allocation.size = pickChurnSize(random);
+        allocation.address = allocator.alignedAlloc(allocation.size, allocation.size);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["initialAddressSpaceMB"] = static_cast<double>(initialAddressSpace / MB);
+    state.counters["addressSpaceMB"] = static_cast<double>((allocator.nextAddress - firstAddress) / MB);
+}
+BENCHMARK(BM_SimpleAllocatorChurn)->ArgName("live")->Arg(256)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+// The same churn against the tbxShm3 host memory heap; mappedMB is the host memory it holds at the end.
+void BM_PhysicalAddressAllocatorHeapChurn(benchmark::State &state) {
+    struct Allocation {
+        uint64_t address;
+        size_t size;
+    };
+    const size_t liveCount = static_cast<size_t>(state.range(0));
+
+    PhysicalAddressAllocatorHeap allocator;
+    std::mt19937 random(0);
+    std::vector<Allocation> live(liveCount);
+    for (auto &allocation : live) {
+        allocation.size = pickChurnSize(random);
+        allocation.address = allocator.reservePhysicalMemory(MEMORY_BANK_SYSTEM, allocation.size, allocation.size);
+    }
+
+    for (auto _ : state) {
+        auto &allocation = live[random() % liveCount];
+        allocator.freePhysicalMemory(MEMORY_BANK_SYSTEM, allocation.address);
+        allocation.size = pickChurnSize(random);
+        allocation.address = allocator.reservePhysicalMemory(MEMORY_BANK_SYSTEM, allocation.size, allocation.size);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    const auto footprint = allocator.getFootprint();
+    state.counters["mappedMB"] = static_cast<double>(footprint.mappedBytes / MB);
+    state.counters["liveMB"] = static_cast<double>(footprint.liveBytes / MB);
+}
+BENCHMARK(BM_PhysicalAddressAllocatorHeapChurn)->ArgName("live")->Arg(256)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+// Arg threads each reserve reservationsPerThread 4KB and 64KB chunks from one bank, as driver threads building page
+// tables at once do. Contended threads switch to refilling their magazines in batches.
+void BM_PhysicalAddressAllocatorReserveThreads(benchmark::State &state) {
+    constexpr size_t reservationsPerThread = 16 * 1024;
+    const size_t threadCount = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        PhysicalAddressAllocatorSimple allocator(1, 64ull * GB, false);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; t++) {
+            threads.emplace_back([&allocator]() {
+                for (size_t i = 0; i < reservationsPerThread; i++) {
+                    const size_t chunkSize = i % 8 == 0 ? 0x10000 : 0x1000;
+                    benchmark::DoNotOptimize(allocator.reservePhysicalMemory(MEMORY_BANK_0, chunkSize, chunkSize));
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * threadCount * reservationsPerThread));
+}
+BENCHMARK(BM_PhysicalAddressAllocatorReserveThreads)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Iterations(20)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "tests/benchmarks/tbx_stub_server.h"
+#include "aub_mem_dump/tbx_proto.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace aub_stream {
+
+TbxStubServer::~TbxStubServer() {
+    stop();
+}
+
+bool TbxStubServer::start() {
+    listenSocket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenSocket < 0) {
+        return false;
+    }
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t addressLength = sizeof(address);
+    if (::bind(listenSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(listenSocket, 1) != 0 ||
+        ::getsockname(listenSocket, reinterpret_cast<sockaddr *>(&address), &addressLength) != 0) {
+        ::close(listenSocket);
+        listenSocket = -1;
+        return false;
+    }
+    port = ntohs(address.sin_port);
+
+    serverThread = std::thread([this]() { serve(); });
+    return true;
+}
+
+void TbxStubServer::stop() {
+    if (listenSocket >= 0) {
+        ::shutdown(listenSocket, SHUT_RDWR);
+    }
+    if (serverThread.joinable()) {
+        serverThread.join();
+    }
+    if (listenSocket >= 0) {
+        ::close(listenSocket);
+        listenSocket = -1;
+    }
+}
+
+bool TbxStubServer::receive(void *buffer, size_t size) {
+    auto data = static_cast<char *>(buffer);
+    while (size > 0) {
+        auto received = ::recv(clientSocket, data, size, 0);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool TbxStubServer::send(const void *buffer, size_t size) {
+    auto data = static_cast<const char *>(buffer);
+    while (size > 0) {
+        auto sent = ::send(clientSocket, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+void TbxStubServer::serve() {
+    clientSocket = ::accept(listenSocket, nullptr, nullptr);
+    if (clientSocket < 0) {
+        return;
+    }
+    int noDelay = 1;
+    ::setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    HAS_MSG request;
+    while (receive(&request.hdr, sizeof(request.hdr))) {
+        if (request.hdr.size > sizeof(request.u) || !receive(&request.u, request.hdr.size)) {
+            break;
+        }
+        messageCount.fetch_add(1, std::memory_order_relaxed);
+
+        HAS_MSG response;
+        memset(&response, 0, sizeof(response));
+        response.hdr.trans_id = request.hdr.trans_id;
+        size_t payloadSize = 0;
+
+        switch (request.hdr.msg_type) {
+        case HAS_MMIO_REQ_TYPE:
+            if (request.u.mmio_req.write) {
+                continue;
+            }
+            response.hdr.msg_type = HAS_MMIO_RES_TYPE;
+            response.hdr.size = sizeof(HAS_MMIO_RES);
+            response.u.mmio_res.data = 0xffffffff;
+            break;
+        case HAS_PCICFG_REQ_TYPE:
+            if (request.u.pcicfg_req.write) {
+                continue;
+            }
+            response.hdr.msg_type = HAS_PCICFG_RES_TYPE;
+            response.hdr.size = sizeof(HAS_PCICFG_RES);
+            response.u.pcicfg_res.data = 0xffffffff;
+            break;
+        case HAS_WRITE_DATA_REQ_TYPE:
+            // HAS_WRITE_DATA_EXT_REQ starts with HAS_WRITE_DATA_REQ, so the payload size is at the same place
+            scratch.resize(request.u.write_req.size);
+            if (!receive(scratch.data(), scratch.size())) {
+                return;
+            }
+            continue;
+        case HAS_READ_DATA_REQ_TYPE:
+            payloadSize = request.u.read_req.size;
+            response.hdr.msg_type = HAS_READ_DATA_RES_TYPE;
+            response.hdr.size = request.hdr.size == sizeof(HAS_READ_DATA_EXT_REQ) ? sizeof(HAS_READ_DATA_EXT_RES)
+                                                                                  : sizeof(HAS_READ_DATA_RES);
+            response.u.read_res.address = request.u.read_req.address;
+            response.u.read_res.size = request.u.read_req.size;
+            break;
+        case HAS_MARKER_REQ_TYPE:
+            response.hdr.msg_type = HAS_MARKER_RES_TYPE;
+            response.hdr.size = 0;
+            break;
+        default:
+            continue;
+        }
+
+        if (!send(&response, sizeof(response.hdr) + response.hdr.size)) {
+            break;
+        }
+        if (payloadSize) {
+            scratch.assign(payloadSize, 0);
+            if (!send(scratch.data(), scratch.size())) {
+                break;
+            }
+        }
+    }
+
+    ::close(clientSocket);
+    clientSocket = -1;
+}
+
+} // namespace aub_stream
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace aub_stream {
+
+// Loopback TBX server speaking just enough of the HAS protocol for AubManager in tbx mode:
+// writes are drained, register and PCI reads return all ones (so register polls complete at once)
+// and memory reads return zeros. Serves a single client connection.
+class TbxStubServer {
+  public:
+    TbxStubServer() = default;
+    ~TbxStubServer();
+
+    bool start();
+    void stop();
+
+    uint16_t getPort() const { return port; }
+    uint64_t getMessageCount() const { return messageCount.load(std::memory_order_relaxed); }
+
+  protected:
+    void serve();
+    bool receive(void *buffer, size_t size);
+    bool send(const void *buffer, size_t size);
+
+    int listenSocket = -1;
+    int clientSocket = -1;
+    uint16_t port = 0;
+    std::thread serverThread;
+    std::atomic<uint64_t> messageCount{0};
+    std::vector<uint8_t> scratch;
+};
+
+} // namespace aub_stream
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "aub_mem_dump/async_file_writer.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace aub_stream;
+
+TEST(AsyncFileWriter, givenMoreChunksThanQueueDepthWhenPushedThenAllAreWrittenInOrder) {
+    std::vector<char> written;
+    AsyncFileWriter writer(2, 16, [&](const char *buffer, size_t size) {
+        written.insert(written.end(), buffer, buffer + size);
+    });
+    EXPECT_EQ(2u, writer.getQueueDepth());
+
+    std::vector<char> expected;
+    std::vector<char> chunk;
+    for (char i = 0; i < 64; i++) {
+        chunk.assign(4, i);
+        expected.insert(expected.end(), chunk.begin(), chunk.end());
+        writer.push(chunk);
+        EXPECT_TRUE(chunk.empty());
+    }
+    writer.drain();
+
+    EXPECT_EQ(expected, written);
+}
+
+TEST(AsyncFileWriter, givenEmptyChunkWhenPushedThenNothingIsWritten) {
+    size_t writeCount = 0;
+    AsyncFileWriter writer(1, 16, [&](const char *buffer, size_t size) {
+        writeCount++;
+    });
+
+    std::vector<char> chunk;
+    writer.push(chunk);
+    writer.drain();
+
+    EXPECT_EQ(0u, writeCount);
+}
+
+TEST(AsyncFileWriter, givenFullQueueWhenPushIsCalledThenItWaitsForWriterThread) {
+    std::atomic<bool> release{false};
+    std::atomic<size_t> writeCount{0};
+    AsyncFileWriter writer(1, 16, [&](const char *buffer, size_t size) {
+        while (!release.load()) {
+        }
+        writeCount++;
+    });
+
+    std::vector<char> chunk(4, 1);
+    writer.push(chunk);
+
+    std::atomic<bool> secondPushDone{false};
+    std::thread producer([&]() {
+        std::vector<char> secondChunk(4, 2);
+        writer.push(secondChunk);
+        secondPushDone = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(secondPushDone);
+
+    release = true;
+    producer.join();
+    EXPECT_TRUE(secondPushDone);
+    writer.drain();
+    EXPECT_EQ(2u, writeCount);
+}
+
+TEST(AsyncFileWriter, givenFailingWriteWhenDrainIsCalledThenErrorIsRethrownOnce) {
+    AsyncFileWriter writer(2, 16, [&](const char *buffer, size_t size) {
+        throw std::runtime_error("write() to file failed\n");
+    });
+
+    std::vector<char> chunk(4, 1);
+    writer.push(chunk);
+
+    EXPECT_THROW(writer.drain(), std::runtime_error);
+    EXPECT_NO_THROW(writer.drain());
+}
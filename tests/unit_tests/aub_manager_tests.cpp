@@ -10,6 +10,7 @@
 #include "aub_mem_dump/aub_tbx_stream.h"
 #include "aub_mem_dump/family_mapper.h"
 #include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/metrics_registry.h"
 #include "aub_mem_dump/page_table.h"
 #include "aub_mem_dump/tbx_stream.h"
 #include "aubstream/aubstream.h"
@@ -22,9 +23,12 @@
 #include "tests/unit_tests/mock_physical_address_allocator.h"
 #include "tests/unit_tests/mock_gpu.h"
 #include "tests/unit_tests/page_table_helper.h"
+#include "tests/variable_backup.h"
 
 #include "test.h"
 
+#include <fstream>
+
 using namespace aub_stream;
 using ::testing::_;
 using ::testing::AtLeast;
@@ -240,6 +244,71 @@ TEST(AubManagerImp, whenAubManagerIsCreatedWithAubFileModeAndOpenIsCalledThenItI
     EXPECT_TRUE(aubManager.getFileName().empty());
 }
 
+TEST(AubManagerImp, givenBufferedAubFileWhenFlushIsCalledThenPendingRecordsAreWrittenToFile) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->AubFileBufferSizeKB.set(1024);
+
+    MockAubManager aubManager(createGpuFunc(), 1, defaultHBMSizePerDevice, 0u, true, mode::aubFile);
+    aubManager.initialize();
+    aubManager.open("test_flush.aub");
+
+    auto stream = static_cast<AubFileStream *>(aubManager.streamAub.get());
+    EXPECT_FALSE(stream->writeBuffer.empty());
+
+    aubManager.flush();
+    EXPECT_TRUE(stream->writeBuffer.empty());
+
+    aubManager.close();
+    std::remove("test_flush.aub");
+}
+
+TEST(AubManagerImp, givenMetricsDumpFileWhenMemoryIsWrittenAndManagerIsClosedThenOperationMetricsAreRecordedAndDumped) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->OperationMetricsDumpFile.set("test_metrics.json");
+
+    auto &registry = MetricsRegistry::get();
+    registry.reset();
+
+    MockAubManager aubManager(createGpuFunc(), 1, defaultHBMSizePerDevice, 0u, true, mode::aubFile);
+    aubManager.initialize();
+    EXPECT_TRUE(registry.isEnabled());
+    aubManager.open("test_metrics.aub");
+
+    std::vector<uint8_t> memory(0x2000, 1);
+    aubManager.writeMemory2({0x10000, memory.data(), memory.size(), MemoryBank::MEMORY_BANK_SYSTEM, 0, 4096});
+
+    auto metrics = aubManager.getOperationMetrics();
+    auto &writeMemory = metrics[static_cast<uint32_t>(OperationType::writeMemory2)];
+    EXPECT_EQ(1u, writeMemory.count);
+    EXPECT_EQ(memory.size(), writeMemory.bytes);
+    EXPECT_LE(1u, metrics[static_cast<uint32_t>(OperationType::pageTableWalk)].count);
+    EXPECT_LE(1u, metrics[static_cast<uint32_t>(OperationType::fileWrite)].count);
+
+    aubManager.close();
+    std::remove("test_metrics.aub");
+
+    std::ifstream file("test_metrics.json");
+    ASSERT_TRUE(file.is_open());
+    std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove("test_metrics.json");
+    EXPECT_NE(std::string::npos, json.find("{\"name\": \"writeMemory2\", \"count\": 1, \"bytes\": 8192"));
+
+    aubManager.resetOperationMetrics();
+    EXPECT_EQ(0u, aubManager.getOperationMetrics()[static_cast<uint32_t>(OperationType::writeMemory2)].count);
+    registry.enable(false);
+}
+
 TEST(AubManagerImp, whenAubManagerIsCreatedWithTbxModeThenItInitializesTbxStream) {
     MockAubManager aubManager(createGpuFunc(), 1, defaultHBMSizePerDevice, 0u, true, mode::tbx);
     aubManager.initialize();
@@ -649,17 +718,17 @@ HWTEST_F(AubManagerTest, whenAubManagerWritesMemoryThenPageTablesParamsCloned, M
     for (auto &ppgtt : aubManager.ppgtts) {
         auto entry = ppgtt.get();
 
-        for (int32_t level = static_cast<int32_t>(ppgtt->getNumLevels() - 1); level >= 0; level--) {
+        for (int32_t level = static_cast<int32_t>(ppgtt->getNumLevels() - 1); level > PageTableLevel::Pte; level--) {
             entry = entry->getChild(0);
 
-            if (level == PageTableLevel::Pte) {
-                EXPECT_TRUE(entry->peekAllocationParams().compressionEnabled);
-                EXPECT_FALSE(entry->peekAllocationParams().uncached);
-            } else {
-                EXPECT_FALSE(entry->peekAllocationParams().compressionEnabled);
-                EXPECT_FALSE(entry->peekAllocationParams().uncached);
-            }
+            EXPECT_FALSE(entry->peekAllocationParams().compressionEnabled);
+            EXPECT_FALSE(entry->peekAllocationParams().uncached);
         }
+
+        auto page = static_cast<PTE *>(entry)->getLeaf(0);
+        ASSERT_NE(nullptr, page);
+        EXPECT_TRUE(page->peekAllocationParams().compressionEnabled);
+        EXPECT_FALSE(page->peekAllocationParams().uncached);
     }
 }
 
@@ -9,6 +9,7 @@
 #include "aub_mem_dump/page_table.h"
 #include "aub_mem_dump/page_table_entry_bits.h"
 #include "aub_mem_dump/page_table_pml5.h"
+#include "aub_mem_dump/pattern_helpers.h"
 #include "aub_mem_dump/aub_tbx_stream.h"
 #include "aubstream/allocation_params.h"
 #include "mock_aub_stream.h"
@@ -32,6 +33,11 @@ static bool isFullyStreamed(PageTable &root, uint64_t va, const std::unordered_m
     PageTable *node = &root;
     for (uint32_t i = 0; i < root.getNumLevels(); ++i) {
         auto idx = node->getIndex(va);
+        // PTE leaves are packed entries, not child nodes
+        if (auto *pte = dynamic_cast<PTE *>(node)) {
+            auto it = streamedEntries.find(pte->getPhysicalAddress() + idx * sizeof(uint64_t));
+            return pte->getLeaf(idx) && it != streamedEntries.end() && it->second == pte->getLeafEntryValue(idx);
+        }
         auto *child = node->getChild(idx);
         if (!child)
             return false;
@@ -80,10 +86,10 @@ TEST_F(AubStreamTest, multipleWriteMemoryShouldKeepSamePhysicalAddress) {
     auto pde1 = pdpe1->getChild(pdpe1->getIndex(gfxAddress));
     EXPECT_NE(0u, pde1->getPhysicalAddress());
 
-    auto pte1 = pde1->getChild(pde1->getIndex(gfxAddress));
+    auto pte1 = static_cast<PTE *>(pde1->getChild(pde1->getIndex(gfxAddress)));
     EXPECT_NE(0u, pte1->getPhysicalAddress());
 
-    auto page1 = pte1->getChild(pte1->getIndex(gfxAddress));
+    auto page1 = pte1->getLeaf(pte1->getIndex(gfxAddress));
     EXPECT_NE(0u, page1->getPhysicalAddress());
 
     stream.writeMemory(&ppgtt1, {gfxAddress, bytes, sizeof(bytes), defaultMemoryBank, DataTypeHintValues::TraceNotype, 65536});
@@ -93,10 +99,10 @@ TEST_F(AubStreamTest, multipleWriteMemoryShouldKeepSamePhysicalAddress) {
     auto pde2 = pdpe2->getChild(pdpe2->getIndex(gfxAddress));
     EXPECT_EQ(pde1->getPhysicalAddress(), pde2->getPhysicalAddress());
 
-    auto pte2 = pde2->getChild(pde2->getIndex(gfxAddress));
+    auto pte2 = static_cast<PTE *>(pde2->getChild(pde2->getIndex(gfxAddress)));
     EXPECT_EQ(pte1->getPhysicalAddress(), pte2->getPhysicalAddress());
 
-    auto page2 = pte2->getChild(pte2->getIndex(gfxAddress));
+    auto page2 = pte2->getLeaf(pte2->getIndex(gfxAddress));
     EXPECT_EQ(page1->getPhysicalAddress(), page2->getPhysicalAddress());
 }
 
@@ -117,10 +123,10 @@ TEST_F(AubStreamTest, expectMemoryShouldntAlterPageTable) {
     auto pde1 = pdpe1->getChild(pdpe1->getIndex(gfxAddress));
     EXPECT_NE(0u, pde1->getPhysicalAddress());
 
-    auto pte1 = pde1->getChild(pde1->getIndex(gfxAddress));
+    auto pte1 = static_cast<PTE *>(pde1->getChild(pde1->getIndex(gfxAddress)));
     EXPECT_NE(0u, pte1->getPhysicalAddress());
 
-    auto page1 = pte1->getChild(pte1->getIndex(gfxAddress));
+    auto page1 = pte1->getLeaf(pte1->getIndex(gfxAddress));
     EXPECT_NE(0u, page1->getPhysicalAddress());
 
     stream.expectMemory(&ppgtt1, gfxAddress, bytes, sizeof(bytes), 0);
@@ -130,10 +136,10 @@ TEST_F(AubStreamTest, expectMemoryShouldntAlterPageTable) {
     auto pde2 = pdpe2->getChild(pdpe2->getIndex(gfxAddress));
     EXPECT_EQ(pde1->getPhysicalAddress(), pde2->getPhysicalAddress());
 
-    auto pte2 = pde2->getChild(pde2->getIndex(gfxAddress));
+    auto pte2 = static_cast<PTE *>(pde2->getChild(pde2->getIndex(gfxAddress)));
     EXPECT_EQ(pte1->getPhysicalAddress(), pte2->getPhysicalAddress());
 
-    auto page2 = pte2->getChild(pte2->getIndex(gfxAddress));
+    auto page2 = pte2->getLeaf(pte2->getIndex(gfxAddress));
     EXPECT_EQ(page1->getPhysicalAddress(), page2->getPhysicalAddress());
 }
 
@@ -159,12 +165,12 @@ TEST_F(AubStreamTest, writeMemoryAndClonePageTablesShouldOnlyShareSamePagesForLa
     auto pde2 = pdpe2->getChild(pdpe2->getIndex(gfxAddress));
     EXPECT_NE(pde1->getPhysicalAddress(), pde2->getPhysicalAddress());
 
-    auto pte1 = pde1->getChild(pde1->getIndex(gfxAddress));
-    auto pte2 = pde2->getChild(pde2->getIndex(gfxAddress));
+    auto pte1 = static_cast<PTE *>(pde1->getChild(pde1->getIndex(gfxAddress)));
+    auto pte2 = static_cast<PTE *>(pde2->getChild(pde2->getIndex(gfxAddress)));
     EXPECT_NE(pte1->getPhysicalAddress(), pte2->getPhysicalAddress());
 
-    auto page1 = pte1->getChild(pte1->getIndex(gfxAddress));
-    auto page2 = pte2->getChild(pte2->getIndex(gfxAddress));
+    auto page1 = pte1->getLeaf(pte1->getIndex(gfxAddress));
+    auto page2 = pte2->getLeaf(pte2->getIndex(gfxAddress));
     EXPECT_EQ(page1->getPhysicalAddress(), page2->getPhysicalAddress());
     EXPECT_EQ(page1->isLocalMemory(), page2->isLocalMemory());
 }
@@ -196,7 +202,7 @@ TEST_F(AubStreamTest, clonePageTablesShouldSetCorrectPageSize) {
         EXPECT_NE(nullptr, pte);
         EXPECT_EQ(pageSize, pte->getPageSize());
 
-        auto page = pte->getChild(pte->getIndex(gpuAddress));
+        auto page = pte->getLeaf(pte->getIndex(gpuAddress));
         EXPECT_EQ(entries[pageId].physicalAddress, page->getPhysicalAddress());
         EXPECT_EQ(entries[pageId].isLocalMemory, page->isLocalMemory());
 
@@ -224,6 +230,20 @@ TEST_F(AubStreamTest, writeMemoryReturnsPageTableEntriesWritten) {
     EXPECT_TRUE(entriesWritten[0].isLocalMemory);
 }
 
+TEST_F(AubStreamTest, writeMemoryAddsCommentWithRangePageSizeAndBanks) {
+    uint8_t bytes[] = {'O', 'C', 'L', 0, 'N', 'E', 'O'};
+
+    PhysicalAddressAllocatorSimple allocator(2, 1, localMemorySupportedInTests);
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_0);
+
+    EXPECT_CALL(stream, addComment(::testing::StrEq("ppgtt:0x1000 - 0x1006  pageSize: 0x10000  banks: bank0"))).Times(1);
+    stream.writeMemory(&ppgtt, {0x1000, bytes, sizeof(bytes), MEMORY_BANK_0, DataTypeHintValues::TraceNotype, 65536});
+
+    PML4 systemPpgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    EXPECT_CALL(stream, addComment(::testing::StrEq("ppgtt(pages only): 0x100000 - 0x101fff  pageSize: 0x1000  banks: sys"))).Times(1);
+    stream.writeMemory(&systemPpgtt, {0x100000, nullptr, 0x2000, MEMORY_BANK_SYSTEM, DataTypeHintValues::TraceNotype, 4096});
+}
+
 TEST_F(AubStreamTest, freeMemoryShouldRemovePTEEntriesLocalMemory) {
     uint8_t bytes[] = {'O', 'C', 'L', 0, 'N', 'E', 'O'};
     uint64_t gfxAddress = 0x1000;
@@ -648,12 +668,12 @@ TEST_F(AubStreamTest, givenGGTT64KBPageEntriesAre4KBAndArePhysicallyContiguous)
 
     stream.writeMemory(&ggtt, gfxAddress, nullptr, sizeof(uint32_t), defaultMemoryBank, DataTypeHintValues::TraceNotype, 65536u);
 
-    auto physicalAddress = ggtt.getChild(0)->getPhysicalAddress();
+    auto physicalAddress = ggtt.getEntry(0) & GGTT::physicalAddressMask;
     EXPECT_EQ(0u, physicalAddress & 0xffff);
     for (int i = 1; i < 16; i++) {
-        auto child = ggtt.getChild(i);
-        ASSERT_NE(nullptr, child);
-        ASSERT_EQ(physicalAddress + i * 4096, child->getPhysicalAddress());
+        auto entry = ggtt.getEntry(i);
+        ASSERT_NE(0u, entry);
+        ASSERT_EQ(physicalAddress + i * 4096, entry & GGTT::physicalAddressMask);
     }
 }
 
@@ -781,6 +801,187 @@ TEST_F(AubFileStreamTest, givenSmallCommentWhenAddCommentThenSingleRecordIsEmitt
     EXPECT_STREQ(buf.data() + 2 * sizeof(uint32_t), message.c_str());
 }
 
+static size_t getFileSize(const std::string &fileName) {
+    std::ifstream file(fileName, std::ifstream::binary | std::ifstream::ate);
+    return static_cast<size_t>(file.tellg());
+}
+
+TEST_F(AubFileStreamTest, givenAubFileBufferSizeSetWhenRecordsAreWrittenThenTheyAreCoalescedUntilPollRecord) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->AubFileBufferSizeKB.set(64);
+
+    const std::string fileName = "buffered_writes.aub";
+    WhiteBox<AubFileStream> stream;
+    stream.open(fileName.c_str());
+    EXPECT_EQ(64u * 1024u, stream.writeBufferSize);
+
+    stream.writeMMIO(0x2000, 0x1);
+    stream.writeMMIO(0x2004, 0x2);
+    EXPECT_EQ(2 * sizeof(CmdServicesMemTraceRegisterWrite), stream.writeBuffer.size());
+    EXPECT_EQ(0u, getFileSize(fileName));
+
+    stream.registerPoll(0x2000, 0x1, 0x1, false, CmdServicesMemTraceRegisterPoll::TimeoutActionValues::Abort);
+    EXPECT_TRUE(stream.writeBuffer.empty());
+    EXPECT_EQ(2 * sizeof(CmdServicesMemTraceRegisterWrite) + sizeof(CmdServicesMemTraceRegisterPoll), getFileSize(fileName));
+
+    stream.close();
+    std::remove(fileName.c_str());
+}
+
+TEST_F(AubFileStreamTest, givenAubFileBufferSizeSetWhenSyncOrCloseIsCalledThenBufferedRecordsAreWrittenToFile) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->AubFileBufferSizeKB.set(64);
+
+    const std::string fileName = "buffered_sync.aub";
+    WhiteBox<AubFileStream> stream;
+    stream.open(fileName.c_str());
+
+    stream.writeMMIO(0x2000, 0x1);
+    EXPECT_EQ(0u, getFileSize(fileName));
+    stream.sync();
+    EXPECT_TRUE(stream.writeBuffer.empty());
+    EXPECT_EQ(sizeof(CmdServicesMemTraceRegisterWrite), getFileSize(fileName));
+
+    stream.writeMMIO(0x2004, 0x2);
+    stream.close();
+    EXPECT_EQ(2 * sizeof(CmdServicesMemTraceRegisterWrite), getFileSize(fileName));
+    std::remove(fileName.c_str());
+}
+
+TEST_F(AubFileStreamTest, givenAubFileBufferSizeSetWhenPayloadExceedsBufferThenItIsWrittenDirectlyAfterPendingRecords) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->AubFileBufferSizeKB.set(1);
+
+    const std::string fileName = "buffered_large.aub";
+    WhiteBox<AubFileStream> stream;
+    stream.open(fileName.c_str());
+
+    char smallRecord[16] = {};
+    std::vector<char> largeRecord(2048, 0x5a);
+    stream.write(smallRecord, sizeof(smallRecord));
+    EXPECT_EQ(sizeof(smallRecord), stream.writeBuffer.size());
+
+    stream.write(largeRecord.data(), static_cast<std::streamsize>(largeRecord.size()));
+    EXPECT_TRUE(stream.writeBuffer.empty());
+
+    stream.close();
+    std::ifstream file(fileName, std::ifstream::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(sizeof(smallRecord) + largeRecord.size(), contents.size());
+    EXPECT_EQ(0, memcmp(contents.data() + sizeof(smallRecord), largeRecord.data(), largeRecord.size()));
+    file.close();
+    std::remove(fileName.c_str());
+}
+
+TEST_F(AubFileStreamTest, givenAsyncWriterEnabledWhenStreamIsClosedThenAllRecordsAreWrittenInOrder) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->AubFileBufferSizeKB.set(1);
+    globalSettings->AubFileAsyncWriterQueueDepth.set(2);
+
+    const std::string fileName = "async_writes.aub";
+    WhiteBox<AubFileStream> stream;
+    stream.open(fileName.c_str());
+    ASSERT_NE(nullptr, stream.asyncWriter.get());
+
+    std::vector<char> expected;
+    for (uint32_t i = 0; i < 256; i++) {
+        std::vector<char> record(i % 7 == 0 ? 3000 : 24, static_cast<char>(i));
+        expected.insert(expected.end(), record.begin(), record.end());
+        stream.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+
+    stream.close();
+    EXPECT_EQ(nullptr, stream.asyncWriter.get());
+
+    std::ifstream file(fileName, std::ifstream::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(expected, contents);
+    file.close();
+    std::remove(fileName.c_str());
+}
+
+static std::vector<char> writeMemoryRecordsToFile(const std::string &fileName) {
+    WhiteBox<AubFileStream> stream;
+    stream.open(fileName.c_str());
+
+    std::vector<uint8_t> memory(0x23003);
+    for (size_t i = 0; i < memory.size(); i++) {
+        memory[i] = static_cast<uint8_t>(i * 7);
+    }
+    stream.writeMMIO(0x2000, 0x1);
+    stream.writeContiguousPages(memory.data(), memory.size(), 0x10000, AddressSpaceValues::TraceNonlocal, DataTypeHintValues::TraceNotype);
+
+    std::vector<PageInfo> pages = {{0x100000, 0x1000, false, 0}, {0x300000, 0x1000, false, 0}, {0x200000, 0x3, false, 0}, {0x400000, 0x1000, false, 0}};
+    stream.writeDiscontiguousPages(memory.data(), 0x3003, pages, DataTypeHintValues::TraceNotype);
+    stream.writeMMIO(0x2004, 0x2);
+    stream.close();
+
+    std::ifstream file(fileName, std::ifstream::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(fileName.c_str());
+    return contents;
+}
+
+TEST_F(AubFileStreamTest, givenVectoredWritesEnabledWhenMemoryRecordsAreWrittenThenFileMatchesStreamedOutput) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+
+    auto expected = writeMemoryRecordsToFile("streamed_writes.aub");
+    ASSERT_FALSE(expected.empty());
+
+    globalSettings->AubFileVectoredWrites.set(true);
+    EXPECT_EQ(expected, writeMemoryRecordsToFile("vectored_writes.aub"));
+
+    globalSettings->AubFileBufferSizeKB.set(16);
+    EXPECT_EQ(expected, writeMemoryRecordsToFile("vectored_buffered_writes.aub"));
+}
+
+TEST_F(AubFileStreamTest, givenVectoredWritesEnabledWhenStreamIsOpenedThenFileDescriptorIsValidUntilClose) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->AubFileVectoredWrites.set(true);
+
+    const std::string fileName = "vectored_descriptor.aub";
+    WhiteBox<AubFileStream> stream;
+    EXPECT_EQ(-1, stream.fileDescriptor);
+    stream.open(fileName.c_str());
+#ifndef _WIN32
+    EXPECT_GE(stream.fileDescriptor, 0);
+#endif
+    stream.close();
+    EXPECT_EQ(-1, stream.fileDescriptor);
+    std::remove(fileName.c_str());
+}
+
 using ComparisonValues = CmdServicesMemTraceMemoryPoll::ComparisonValues;
 
 TEST_F(AubStreamTest, givenComparisonModesWhenCompareMemoryIsCalledThenCorrectResultIsReturned) {
@@ -1341,3 +1542,193 @@ TEST_F(AubFileStreamWritePagesTest, givenSmallAlignedDiscontiguousEntriesWhenWri
     auto *writtenPayload = reinterpret_cast<const uint8_t *>(stream.writtenData.data() + headerSize);
     EXPECT_EQ(0, memcmp(memory.data(), writtenPayload, memory.size()));
 }
+
+TEST_F(AubFileStreamWritePagesTest, givenElideRepeatedPagesWhenWriteContiguousPagesThenUniformPagesAreWrittenAsRepeatRecords) {
+    MockWriteAubFileStream stream;
+    stream.elideRepeatedPages = true;
+
+    std::vector<uint32_t> memory(4 * 1024 + 25, 0);
+    for (size_t i = 2 * 1024; i < 3 * 1024; i++) {
+        memory[i] = static_cast<uint32_t>(i);
+    }
+    std::fill(memory.begin() + 3 * 1024, memory.begin() + 4 * 1024, 0xDEADBEEF);
+    auto size = memory.size() * sizeof(uint32_t);
+    uint64_t physAddress = 0x100000;
+
+    stream.writeContiguousPages(memory.data(), size, physAddress, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+
+    struct ExpectedRecord {
+        uint32_t repeat;
+        size_t offset;
+        size_t size;
+    } expectedRecords[] = {{CmdServicesMemTraceMemoryWrite::RepeatMemoryValues::Repeat, 0, 0x2000},
+                           {CmdServicesMemTraceMemoryWrite::RepeatMemoryValues::NoRepeat, 0x2000, 0x1000},
+                           {CmdServicesMemTraceMemoryWrite::RepeatMemoryValues::Repeat, 0x3000, 0x1000},
+                           {CmdServicesMemTraceMemoryWrite::RepeatMemoryValues::NoRepeat, 0x4000, 100}};
+
+    auto headerSize = sizeof(CmdServicesMemTraceMemoryWrite) - sizeof(CmdServicesMemTraceMemoryWrite::data);
+    size_t offset = 0;
+    for (auto &expected : expectedRecords) {
+        ASSERT_LT(offset, stream.writtenData.size());
+        auto *cmd = reinterpret_cast<const CmdServicesMemTraceMemoryWrite *>(stream.writtenData.data() + offset);
+        EXPECT_TRUE(cmd->matchesHeader());
+        EXPECT_EQ(expected.repeat, cmd->repeatMemory);
+        EXPECT_EQ(physAddress + expected.offset, cmd->address);
+        EXPECT_EQ(expected.size, cmd->dataSizeInBytes);
+        EXPECT_EQ(CmdServicesMemTraceMemoryWrite::AddressSpaceValues::TraceLocal, cmd->addressSpace);
+
+        auto payloadSize = expected.repeat ? sizeof(uint32_t) : expected.size;
+        EXPECT_EQ((headerSize + payloadSize) / sizeof(uint32_t) - 1, cmd->dwordCount);
+        auto *payload = stream.writtenData.data() + offset + headerSize;
+        EXPECT_EQ(0, memcmp(reinterpret_cast<const uint8_t *>(memory.data()) + expected.offset, payload, payloadSize));
+        offset += headerSize + payloadSize;
+    }
+    EXPECT_EQ(offset, stream.writtenData.size());
+}
+
+TEST_F(AubFileStreamWritePagesTest, givenElideRepeatedPagesDisabledWhenWriteContiguousPagesThenZeroPagesAreWrittenAsIs) {
+    MockWriteAubFileStream stream;
+
+    std::vector<uint8_t> memory(0x2000, 0);
+    stream.writeContiguousPages(memory.data(), memory.size(), 0x100000, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+
+    auto headerSize = sizeof(CmdServicesMemTraceMemoryWrite) - sizeof(CmdServicesMemTraceMemoryWrite::data);
+    ASSERT_EQ(headerSize + memory.size(), stream.writtenData.size());
+    auto *cmd = reinterpret_cast<const CmdServicesMemTraceMemoryWrite *>(stream.writtenData.data());
+    EXPECT_EQ(static_cast<uint32_t>(CmdServicesMemTraceMemoryWrite::RepeatMemoryValues::NoRepeat), cmd->repeatMemory);
+}
+
+TEST_F(AubFileStreamWritePagesTest, givenElideRepeatedPagesWhenWriteDiscontiguousPagesThenUniformPagesAreSplitIntoRepeatRecords) {
+    MockWriteAubFileStream stream;
+    stream.elideRepeatedPages = true;
+
+    std::vector<PageInfo> entries = {
+        {0x200000, 4096, true, MEMORY_BANK_0},
+        {0x300000, 4096, true, MEMORY_BANK_0},
+        {0x400000, 4096, true, MEMORY_BANK_0}};
+    std::vector<uint8_t> memory(3 * 4096, 0);
+    for (size_t i = 4096; i < 2 * 4096; i++) {
+        memory[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    stream.writeDiscontiguousPages(memory.data(), memory.size(), entries, DataTypeHintValues::TraceNotype);
+
+    auto writeHeaderSize = sizeof(CmdServicesMemTraceMemoryWrite) - sizeof(CmdServicesMemTraceMemoryWrite::data);
+    auto discontiguousHeaderSize = sizeof(CmdServicesMemTraceMemoryWriteDiscontiguous) - sizeof(CmdServicesMemTraceMemoryWriteDiscontiguous::data);
+    ASSERT_EQ(2 * (writeHeaderSize + sizeof(uint32_t)) + discontiguousHeaderSize + 4096, stream.writtenData.size());
+
+    size_t offset = 0;
+    auto *repeatCmd = reinterpret_cast<const CmdServicesMemTraceMemoryWrite *>(stream.writtenData.data());
+    EXPECT_TRUE(repeatCmd->matchesHeader());
+    EXPECT_EQ(1u, repeatCmd->repeatMemory);
+    EXPECT_EQ(entries[0].physicalAddress, repeatCmd->address);
+    EXPECT_EQ(4096u, repeatCmd->dataSizeInBytes);
+    offset += writeHeaderSize + sizeof(uint32_t);
+
+    auto *discontiguousCmd = reinterpret_cast<const CmdServicesMemTraceMemoryWriteDiscontiguous *>(stream.writtenData.data() + offset);
+    EXPECT_TRUE(discontiguousCmd->matchesHeader());
+    EXPECT_EQ(1u, discontiguousCmd->numberOfAddressDataPairs);
+    EXPECT_EQ(entries[1].physicalAddress, discontiguousCmd->Dword_2_To_190[0].address);
+    EXPECT_EQ(0, memcmp(memory.data() + 4096, stream.writtenData.data() + offset + discontiguousHeaderSize, 4096));
+    offset += discontiguousHeaderSize + 4096;
+
+    repeatCmd = reinterpret_cast<const CmdServicesMemTraceMemoryWrite *>(stream.writtenData.data() + offset);
+    EXPECT_TRUE(repeatCmd->matchesHeader());
+    EXPECT_EQ(1u, repeatCmd->repeatMemory);
+    EXPECT_EQ(entries[2].physicalAddress, repeatCmd->address);
+}
+
+TEST(PatternHelpers, givenBuffersWhenIsUniformDwordPatternIsCalledThenOnlyRepeatedDwordBuffersAreDetected) {
+    std::vector<uint32_t> buffer(1024 + 3, 0x12345678);
+    uint32_t value = 0;
+    EXPECT_TRUE(isUniformDwordPattern(buffer.data(), buffer.size() * sizeof(uint32_t), value));
+    EXPECT_EQ(0x12345678u, value);
+
+    for (size_t position : {size_t(0), size_t(1), size_t(17), size_t(1023), buffer.size() - 1}) {
+        auto copy = buffer;
+        copy[position] ^= 0x100;
+        EXPECT_FALSE(isUniformDwordPattern(copy.data(), copy.size() * sizeof(uint32_t), value)) << position;
+    }
+
+    EXPECT_FALSE(isUniformDwordPattern(buffer.data(), 0, value));
+    EXPECT_FALSE(isUniformDwordPattern(buffer.data(), 6, value));
+}
+
+TEST_F(AubFileStreamWritePagesTest, givenPageContentCacheWhenUnchangedPagesAreWrittenAgainThenOnlyChangedPagesAreEmitted) {
+    MockWriteAubFileStream stream;
+    stream.pageContentCache = std::make_unique<PageContentCache>(64);
+
+    std::vector<uint8_t> memory(4 * 4096);
+    for (size_t i = 0; i < memory.size(); i++) {
+        memory[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+    uint64_t physAddress = 0x100000;
+    auto headerSize = sizeof(CmdServicesMemTraceMemoryWrite) - sizeof(CmdServicesMemTraceMemoryWrite::data);
+
+    stream.writeContiguousPages(memory.data(), memory.size(), physAddress, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+    EXPECT_EQ(headerSize + memory.size(), stream.writtenData.size());
+    EXPECT_EQ(0u, stream.getDedupBytesSaved());
+
+    stream.writtenData.clear();
+    stream.writeContiguousPages(memory.data(), memory.size(), physAddress, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+    EXPECT_TRUE(stream.writtenData.empty());
+    EXPECT_EQ(memory.size(), stream.getDedupBytesSaved());
+
+    memory[2 * 4096 + 5]++;
+    stream.writtenData.clear();
+    stream.writeContiguousPages(memory.data(), memory.size(), physAddress, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+    ASSERT_EQ(headerSize + 4096, stream.writtenData.size());
+    auto *cmd = reinterpret_cast<const CmdServicesMemTraceMemoryWrite *>(stream.writtenData.data());
+    EXPECT_EQ(physAddress + 2 * 4096, cmd->address);
+    EXPECT_EQ(4096u, cmd->dataSizeInBytes);
+    EXPECT_EQ(0, memcmp(memory.data() + 2 * 4096, stream.writtenData.data() + headerSize, 4096));
+    EXPECT_EQ(2 * memory.size() - 4096, stream.getDedupBytesSaved());
+}
+
+TEST_F(AubFileStreamWritePagesTest, givenPageContentCacheWhenPartialPageIsWrittenThenPageIsEmittedOnNextFullWrite) {
+    MockWriteAubFileStream stream;
+    stream.pageContentCache = std::make_unique<PageContentCache>(64);
+
+    std::vector<uint8_t> memory(4096, 0x5A);
+    uint64_t physAddress = 0x100000;
+    auto headerSize = sizeof(CmdServicesMemTraceMemoryWrite) - sizeof(CmdServicesMemTraceMemoryWrite::data);
+
+    stream.writeContiguousPages(memory.data(), memory.size(), physAddress, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+    uint32_t value = 0x12345678;
+    stream.writeContiguousPages(&value, sizeof(value), physAddress + 0x100, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+
+    stream.writtenData.clear();
+    stream.writeContiguousPages(memory.data(), memory.size(), physAddress, AddressSpaceValues::TraceLocal, DataTypeHintValues::TraceNotype);
+    EXPECT_EQ(headerSize + memory.size(), stream.writtenData.size());
+    EXPECT_EQ(0u, stream.getDedupBytesSaved());
+}
+
+TEST_F(AubFileStreamWritePagesTest, givenPageContentCacheWhenDiscontiguousPagesAreWrittenAgainThenUnchangedEntriesAreSkipped) {
+    MockWriteAubFileStream stream;
+    stream.pageContentCache = std::make_unique<PageContentCache>(64);
+
+    std::vector<PageInfo> entries = {
+        {0x200000, 4096, true, MEMORY_BANK_0},
+        {0x300000, 4096, true, MEMORY_BANK_0},
+        {0x400000, 4096, true, MEMORY_BANK_0}};
+    std::vector<uint8_t> memory(3 * 4096);
+    for (size_t i = 0; i < memory.size(); i++) {
+        memory[i] = static_cast<uint8_t>(i * 3 + 1);
+    }
+
+    stream.writeDiscontiguousPages(memory.data(), memory.size(), entries, DataTypeHintValues::TraceNotype);
+    auto headerSize = sizeof(CmdServicesMemTraceMemoryWriteDiscontiguous) - sizeof(CmdServicesMemTraceMemoryWriteDiscontiguous::data);
+    EXPECT_EQ(headerSize + memory.size(), stream.writtenData.size());
+
+    memory[4096]++;
+    stream.writtenData.clear();
+    stream.writeDiscontiguousPages(memory.data(), memory.size(), entries, DataTypeHintValues::TraceNotype);
+
+    ASSERT_EQ(headerSize + 4096, stream.writtenData.size());
+    auto *cmd = reinterpret_cast<const CmdServicesMemTraceMemoryWriteDiscontiguous *>(stream.writtenData.data());
+    EXPECT_TRUE(cmd->matchesHeader());
+    EXPECT_EQ(1u, cmd->numberOfAddressDataPairs);
+    EXPECT_EQ(entries[1].physicalAddress, cmd->Dword_2_To_190[0].address);
+    EXPECT_EQ(0, memcmp(memory.data() + 4096, stream.writtenData.data() + headerSize, 4096));
+    EXPECT_EQ(2 * 4096u, stream.getDedupBytesSaved());
+}
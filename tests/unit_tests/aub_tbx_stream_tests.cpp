@@ -333,6 +333,41 @@ TEST(TbxStream, GivenNoContextExecutedWhenPollingForCompletionThenFunctionReturn
     tbxStream->registerPoll(0x2234, 1, 1, false, CmdServicesMemTraceRegisterPoll::TimeoutActionValues::Abort);
 }
 
+TEST(TbxStream, GivenPollTimeoutWhenRegisterNeverMatchesThenAbortActionThrowsAndIgnoreActionReturns) {
+    auto tbxStream = std::make_unique<MockTbxStream>();
+    auto socket = new MockTbxSocketsImp();
+
+    tbxStream->socket = socket;
+    tbxStream->pollPolicy.timeoutMilliseconds = 1;
+
+    EXPECT_CALL(*socket, readMMIO(0x2234, _)).WillRepeatedly(::testing::Invoke([&](uint32_t offset, uint32_t *data) { *data = 0; return true; }));
+
+    EXPECT_THROW(tbxStream->TbxStream::registerPoll(0x2234, 2, 2, false, CmdServicesMemTraceRegisterPoll::TimeoutActionValues::Abort), std::runtime_error);
+    EXPECT_NO_THROW(tbxStream->TbxStream::registerPoll(0x2234, 2, 2, false, CmdServicesMemTraceRegisterPoll::TimeoutActionValues::Ignore));
+
+    auto &statistics = tbxStream->getPollStatistics();
+    EXPECT_EQ(2u, statistics.pollCount);
+    EXPECT_EQ(2u, statistics.timeoutCount);
+    EXPECT_GE(statistics.iterationCount, 2u);
+}
+
+TEST(TbxStream, GivenRegisterMatchingAfterFewReadsWhenPollingThenReadsAreCountedInPollStatistics) {
+    auto tbxStream = std::make_unique<MockTbxStream>();
+    auto socket = new MockTbxSocketsImp();
+
+    tbxStream->socket = socket;
+
+    uint32_t reads = 0;
+    EXPECT_CALL(*socket, readMMIO(0x2234, _)).Times(3).WillRepeatedly(::testing::Invoke([&](uint32_t offset, uint32_t *data) { *data = ++reads == 3 ? 2 : 0; return true; }));
+
+    tbxStream->TbxStream::registerPoll(0x2234, 2, 2, false, CmdServicesMemTraceRegisterPoll::TimeoutActionValues::Abort);
+
+    auto &statistics = tbxStream->getPollStatistics();
+    EXPECT_EQ(1u, statistics.pollCount);
+    EXPECT_EQ(3u, statistics.iterationCount);
+    EXPECT_EQ(0u, statistics.timeoutCount);
+}
+
 TEST(TbxStream, SocketProperClosingAtModeTbxWhenCloseSocketFunctionIsCall) {
 
     auto tbxStream = std::make_unique<MockTbxStream>();
@@ -409,6 +444,24 @@ TEST(AubShmStreamTest, writeContiguousPagesInSHM4ModeWithCorrectValuesThenTransl
     EXPECT_EQ(inVal, outVal);
 }
 
+TEST(AubShmStreamTest, givenPollTimeoutWhenSharedMemoryPollNeverMatchesThenPollThrows) {
+    MockTbxShmStream stream(mode::tbxShm);
+    uint32_t sharedValue = 5;
+    stream.baseInit([&sharedValue](uint64_t physAddress, size_t size, bool isLocalMemory, void *&p, size_t &availableSize) {
+        p = &sharedValue;
+        availableSize = sizeof(sharedValue);
+    });
+    stream.pollPolicy.timeoutMilliseconds = 1;
+
+    std::vector<PageInfo> entries = {{0x1000, sizeof(sharedValue), false, 0}};
+    EXPECT_NO_THROW(stream.baseMemoryPoll(entries, 5, CmdServicesMemTraceMemoryPoll::ComparisonValues::Equal));
+    EXPECT_THROW(stream.baseMemoryPoll(entries, 6, CmdServicesMemTraceMemoryPoll::ComparisonValues::Equal), std::runtime_error);
+
+    auto &statistics = stream.getPollStatistics();
+    EXPECT_EQ(2u, statistics.pollCount);
+    EXPECT_EQ(1u, statistics.timeoutCount);
+}
+
 TEST(AubShmStreamTest, SocketProperClosingAtModeTbxShmWhenCloseSocketFunctionIsCall) {
     MockTbxShmStream stream(mode::tbxShm);
     uint64_t inVal = 1977;
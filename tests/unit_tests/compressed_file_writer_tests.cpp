@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "aub_mem_dump/compressed_file_writer.h"
+#include "aub_mem_dump/hash_helpers.h"
+#include "aubstream/hint_values.h"
+#include "mock_aub_stream.h"
+#include "tests/variable_backup.h"
+
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+using namespace aub_stream;
+
+namespace {
+uint32_t readDword(const std::vector<char> &data, size_t offset) {
+    uint32_t value = 0;
+    memcpy(&value, data.data() + offset, sizeof(value));
+    return value;
+}
+
+std::vector<char> decompressBlock(const uint8_t *src, size_t size) {
+    std::vector<char> output;
+    size_t position = 0;
+    auto readLength = [&](size_t length) {
+        if (length == 15) {
+            uint8_t byte;
+            do {
+                byte = src[position++];
+                length += byte;
+            } while (byte == 255);
+        }
+        return length;
+    };
+    while (position < size) {
+        auto token = src[position++];
+        auto literalLength = readLength(token >> 4);
+        output.insert(output.end(), src + position, src + position + literalLength);
+        position += literalLength;
+        if (position >= size) {
+            break;
+        }
+        size_t offset = src[position] | (src[position + 1] << 8);
+        position += 2;
+        auto matchLength = readLength(token & 0xF) + 4;
+        auto start = output.size() - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            output.push_back(output[start + i]);
+        }
+    }
+    return output;
+}
+
+// decodes one LZ4 frame starting at offset, returns offset past the frame
+size_t decompressFrame(const std::vector<char> &frame, size_t offset, std::vector<char> &output) {
+    EXPECT_EQ(lz4::frameMagic, readDword(frame, offset));
+    auto descriptor = reinterpret_cast<const uint8_t *>(frame.data() + offset + 4);
+    EXPECT_EQ(0x68, descriptor[0]);
+    EXPECT_EQ(static_cast<uint8_t>((xxHash32(descriptor, 10) >> 8) & 0xFF), descriptor[10]);
+    uint64_t contentSize = 0;
+    memcpy(&contentSize, descriptor + 2, sizeof(contentSize));
+
+    auto initialSize = output.size();
+    offset += 4 + 11;
+    while (auto blockHeader = readDword(frame, offset)) {
+        offset += 4;
+        auto blockSize = blockHeader & ~lz4::uncompressedBlockFlag;
+        auto data = reinterpret_cast<const uint8_t *>(frame.data() + offset);
+        if (blockHeader & lz4::uncompressedBlockFlag) {
+            output.insert(output.end(), data, data + blockSize);
+        } else {
+            auto block = decompressBlock(data, blockSize);
+            output.insert(output.end(), block.begin(), block.end());
+        }
+        offset += blockSize;
+    }
+    EXPECT_EQ(contentSize, output.size() - initialSize);
+    return offset + 4;
+}
+} // namespace
+
+TEST(HashHelpers, givenKnownInputsWhenXxHash32IsCalledThenReferenceValuesAreReturned) {
+    EXPECT_EQ(0x02CC5D05u, xxHash32("", 0));
+    EXPECT_EQ(0x550D7456u, xxHash32("a", 1));
+    EXPECT_EQ(0x32D153FFu, xxHash32("abc", 3));
+    EXPECT_EQ(0xE2293B2Fu, xxHash32("Nobody inspects the spammish repetition", 39));
+}
+
+TEST(Lz4Compression, givenVariousInputsWhenBlockIsCompressedThenItDecompressesToOriginalData) {
+    std::mt19937 generator(1);
+    std::vector<std::vector<char>> inputs = {
+        std::vector<char>(0),
+        std::vector<char>(5, 1),
+        std::vector<char>(13, 0),
+        std::vector<char>(64 * 1024, 0),
+        std::vector<char>(100 * 1024)};
+    for (size_t i = 0; i < inputs.back().size(); i++) {
+        inputs.back()[i] = (i / 4096) % 2 ? static_cast<char>(generator()) : static_cast<char>(i % 17);
+    }
+
+    std::vector<uint32_t> hashTable;
+    for (auto &input : inputs) {
+        std::vector<uint8_t> compressed(lz4::getMaxCompressedBlockSize(input.size()));
+        auto compressedSize = lz4::compressBlock(reinterpret_cast<const uint8_t *>(input.data()), input.size(), compressed.data(), hashTable);
+        ASSERT_LE(compressedSize, compressed.size());
+        EXPECT_EQ(input, decompressBlock(compressed.data(), compressedSize));
+    }
+}
+
+TEST(Lz4Compression, givenZeroFilledChunkWhenFrameIsAppendedThenItIsMuchSmallerThanInput) {
+    std::vector<char> input(1024 * 1024, 0);
+    std::vector<char> frame;
+    std::vector<uint32_t> hashTable;
+    lz4::appendFrame(frame, input.data(), input.size(), hashTable);
+
+    EXPECT_LT(frame.size(), input.size() / 100);
+
+    std::vector<char> output;
+    EXPECT_EQ(frame.size(), decompressFrame(frame, 0, output));
+    EXPECT_EQ(input, output);
+}
+
+TEST(Lz4Compression, givenIncompressibleChunkWhenFrameIsAppendedThenBlockIsStoredUncompressed) {
+    std::mt19937 generator(2);
+    std::vector<char> input(4096);
+    for (auto &byte : input) {
+        byte = static_cast<char>(generator());
+    }
+    std::vector<char> frame;
+    std::vector<uint32_t> hashTable;
+    lz4::appendFrame(frame, input.data(), input.size(), hashTable);
+
+    EXPECT_NE(0u, readDword(frame, 4 + 11) & lz4::uncompressedBlockFlag);
+
+    std::vector<char> output;
+    decompressFrame(frame, 0, output);
+    EXPECT_EQ(input, output);
+}
+
+TEST(CompressedFileWriter, givenChunksWhenFinishIsCalledThenFramesAreWrittenInOrderFollowedByFrameIndex) {
+    std::vector<char> file;
+    CompressedFileWriter writer(3, [&](const char *buffer, size_t size) {
+        file.insert(file.end(), buffer, buffer + size);
+    });
+    EXPECT_EQ(3u, writer.getWorkerCount());
+
+    std::vector<char> expected;
+    std::vector<char> chunk;
+    for (uint32_t i = 0; i < 20; i++) {
+        chunk.assign(1000 + i * 100, static_cast<char>(i));
+        expected.insert(expected.end(), chunk.begin(), chunk.end());
+        writer.push(chunk);
+    }
+    writer.finish();
+
+    const auto &index = writer.getFrameIndex();
+    ASSERT_EQ(20u, index.size());
+
+    std::vector<char> output;
+    size_t offset = 0;
+    for (auto &entry : index) {
+        EXPECT_EQ(offset, entry.compressedOffset);
+        EXPECT_EQ(output.size(), entry.uncompressedOffset);
+        offset = decompressFrame(file, offset, output);
+    }
+    EXPECT_EQ(expected, output);
+
+    auto indexFrameSize = readDword(file, file.size() - sizeof(uint32_t));
+    ASSERT_EQ(file.size() - offset, indexFrameSize);
+    EXPECT_EQ(lz4::skippableFrameMagic, readDword(file, offset));
+    EXPECT_EQ(indexFrameSize - 8, readDword(file, offset + 4));
+    EXPECT_EQ(lz4::frameIndexVersion, readDword(file, offset + 8));
+    EXPECT_EQ(20u, readDword(file, offset + 12));
+    EXPECT_EQ(0, memcmp(file.data() + offset + 16, index.data(), index.size() * sizeof(index[0])));
+}
+
+TEST(CompressedFileWriter, givenFailingWriteWhenDrainIsCalledThenErrorIsRethrownOnce) {
+    CompressedFileWriter writer(2, [&](const char *buffer, size_t size) {
+        throw std::runtime_error("write() to file failed\n");
+    });
+
+    std::vector<char> chunk(64, 1);
+    writer.push(chunk);
+
+    EXPECT_THROW(writer.drain(), std::runtime_error);
+    EXPECT_NO_THROW(writer.drain());
+}
+
+static std::vector<char> writeAubFile(const std::string &fileName) {
+    WhiteBox<AubFileStream> stream;
+    stream.open(fileName.c_str());
+
+    std::vector<uint8_t> memory(0x42003, 0);
+    for (size_t i = 0x20000; i < memory.size(); i++) {
+        memory[i] = static_cast<uint8_t>(i * 13);
+    }
+    stream.writeMMIO(0x2000, 0x1);
+    stream.writeContiguousPages(memory.data(), memory.size(), 0x10000, AddressSpaceValues::TraceNonlocal, DataTypeHintValues::TraceNotype);
+    stream.registerPoll(0x2000, 0x1, 0x1, false, CmdServicesMemTraceRegisterPoll::TimeoutActionValues::Abort);
+    stream.writeContiguousPages(memory.data(), 0x1000, 0x80000, AddressSpaceValues::TraceNonlocal, DataTypeHintValues::TraceNotype);
+    stream.close();
+
+    std::ifstream file(fileName, std::ifstream::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(fileName.c_str());
+    return contents;
+}
+
+TEST(AubFileStreamCompression, givenCompressionEnabledWhenAubFileIsWrittenThenFramesDecompressToUncompressedAubFile) {
+    if (Settings::disabled()) {
+        GTEST_SKIP();
+    }
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+
+    auto expected = writeAubFile("uncompressed.aub");
+
+    globalSettings->AubFileCompression.set(true);
+    globalSettings->AubFileCompressionThreads.set(2);
+    globalSettings->AubFileBufferSizeKB.set(64);
+    auto compressed = writeAubFile("compressed.aub");
+    EXPECT_LT(compressed.size(), expected.size());
+
+    auto indexFrameSize = readDword(compressed, compressed.size() - sizeof(uint32_t));
+    auto indexOffset = compressed.size() - indexFrameSize;
+    auto frameCount = readDword(compressed, indexOffset + 12);
+    EXPECT_GT(frameCount, 1u);
+
+    std::vector<char> output;
+    size_t offset = 0;
+    for (uint32_t i = 0; i < frameCount; i++) {
+        offset = decompressFrame(compressed, offset, output);
+    }
+    EXPECT_EQ(indexOffset, offset);
+    EXPECT_EQ(expected, output);
+}
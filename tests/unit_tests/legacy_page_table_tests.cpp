@@ -97,7 +97,7 @@ TEST(LegacyPDP4, allocateChildReturnsNonNullPointer) {
     LegacyPDP4 pageTable(*gpu, &allocator, MEMORY_BANK_0);
     auto child = pageTable.allocateChild(*gpu, 4096, pageTable.getMemoryBank());
     EXPECT_NE(nullptr, child);
-    delete child;
+    pageTable.getArena().destroy(child);
 }
 
 TEST_P(PDP4LegacyTest, ctor) {
@@ -199,11 +199,11 @@ TEST_F(LegacyPageTableTest, GivenHBMTableAndSystemLastLevelPageVerifyMemoryLocat
     ASSERT_NE(nullptr, pde);
     EXPECT_TRUE(pde->isLocalMemory());
 
-    auto pte = pde->getChild(0);
+    auto pte = static_cast<PTE *>(pde->getChild(0));
     ASSERT_NE(nullptr, pte);
     EXPECT_TRUE(pte->isLocalMemory());
 
-    auto page = pte->getChild(0);
+    auto page = pte->getLeaf(0);
     ASSERT_NE(nullptr, page);
     EXPECT_FALSE(page->isLocalMemory());
 }
@@ -300,11 +300,10 @@ TEST_F(LegacyPageTableTest, GivenHBMGGTTAubStreamWriteMemoryVerifyChildPageAttri
     uint32_t data = 0xabcdabcd;
     stream.writeMemory(&ggtt, 0, &data, sizeof(data), MEMORY_BANK_0, DataTypeHintValues::TraceNotype, 4096);
 
-    auto child = ggtt.getChild(0);
-    ASSERT_NE(nullptr, child);
-    EXPECT_NE(0u, child->getPhysicalAddress());
-    EXPECT_EQ(ggtt.getMemoryBank(), child->getMemoryBank());
-    EXPECT_TRUE(child->isLocalMemory());
+    auto entry = ggtt.getEntry(0);
+    EXPECT_NE(0u, entry & toBitValue(GGTT::validBit));
+    EXPECT_NE(0u, entry & GGTT::physicalAddressMask);
+    EXPECT_NE(0u, entry & toBitValue(GGTT::localMemoryBit));
 }
 
 TEST_F(LegacyPageTableTest, GivenSystemmemGGTTAubStreamWriteMemoryVerifyChildPageAttributes) {
@@ -314,11 +313,10 @@ TEST_F(LegacyPageTableTest, GivenSystemmemGGTTAubStreamWriteMemoryVerifyChildPag
     uint32_t data = 0xabcdabcd;
     stream.writeMemory(&ggtt, 0, &data, sizeof(data), MEMORY_BANK_SYSTEM, DataTypeHintValues::TraceNotype, 4096);
 
-    auto child = ggtt.getChild(0);
-    ASSERT_NE(nullptr, child);
-    EXPECT_NE(0u, child->getPhysicalAddress());
-    EXPECT_EQ(ggtt.getMemoryBank(), child->getMemoryBank());
-    EXPECT_FALSE(child->isLocalMemory());
+    auto entry = ggtt.getEntry(0);
+    EXPECT_NE(0u, entry & toBitValue(GGTT::validBit));
+    EXPECT_NE(0u, entry & GGTT::physicalAddressMask);
+    EXPECT_EQ(0u, entry & toBitValue(GGTT::localMemoryBit));
 }
 
 TEST_F(LegacyPageTableTest, GivenLocalMemoryGGTTWhenCallingExpectMemoryThenExpectMemoryTableGetsCalled) {
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "aub_mem_dump/metrics_registry.h"
+
+#include <thread>
+
+using namespace aub_stream;
+
+struct MetricsRegistryTest : public ::testing::Test {
+    void SetUp() override {
+        wasEnabled = registry.isEnabled();
+        registry.reset();
+    }
+    void TearDown() override {
+        registry.reset();
+        registry.enable(wasEnabled);
+    }
+
+    const OperationMetrics getMetrics(OperationType operation) {
+        return registry.getOperationMetrics()[static_cast<uint32_t>(operation)];
+    }
+
+    MetricsRegistry &registry = MetricsRegistry::get();
+    bool wasEnabled = false;
+};
+
+TEST_F(MetricsRegistryTest, givenLatenciesWhenHistogramBucketIsComputedThenPowerOfTwoRangesAreUsed) {
+    EXPECT_EQ(0u, MetricsRegistry::getHistogramBucket(0));
+    EXPECT_EQ(0u, MetricsRegistry::getHistogramBucket(1));
+    EXPECT_EQ(1u, MetricsRegistry::getHistogramBucket(2));
+    EXPECT_EQ(1u, MetricsRegistry::getHistogramBucket(3));
+    EXPECT_EQ(10u, MetricsRegistry::getHistogramBucket(1024));
+    EXPECT_EQ(10u, MetricsRegistry::getHistogramBucket(2047));
+    EXPECT_EQ(OperationMetrics::histogramBucketCount - 1, MetricsRegistry::getHistogramBucket(~0ull));
+}
+
+TEST_F(MetricsRegistryTest, givenRecordedOperationsWhenMetricsAreQueriedThenCountsBytesAndHistogramAreReturned) {
+    registry.record(OperationType::fileWrite, 100, 1000);
+    registry.record(OperationType::fileWrite, 50, 3000);
+    registry.record(OperationType::socketRoundTrip, 4, 10);
+
+    auto metrics = registry.getOperationMetrics();
+    ASSERT_EQ(static_cast<size_t>(OperationType::count), metrics.size());
+
+    auto &fileWrite = metrics[static_cast<uint32_t>(OperationType::fileWrite)];
+    EXPECT_STREQ("fileWrite", fileWrite.name);
+    EXPECT_EQ(2u, fileWrite.count);
+    EXPECT_EQ(150u, fileWrite.bytes);
+    EXPECT_EQ(4000u, fileWrite.totalNanoseconds);
+    EXPECT_EQ(3000u, fileWrite.maxNanoseconds);
+    EXPECT_EQ(1u, fileWrite.latencyHistogram[9]);
+    EXPECT_EQ(1u, fileWrite.latencyHistogram[11]);
+
+    EXPECT_EQ(1u, metrics[static_cast<uint32_t>(OperationType::socketRoundTrip)].count);
+    EXPECT_EQ(0u, metrics[static_cast<uint32_t>(OperationType::writeMemory2)].count);
+
+    registry.reset();
+    EXPECT_EQ(0u, getMetrics(OperationType::fileWrite).count);
+    EXPECT_EQ(0u, getMetrics(OperationType::fileWrite).latencyHistogram[9]);
+}
+
+TEST_F(MetricsRegistryTest, givenDisabledRegistryWhenScopedTimerEndsThenNothingIsRecorded) {
+    registry.enable(false);
+    {
+        ScopedOperationTimer timer(OperationType::pageTableWalk, 4096);
+    }
+    EXPECT_EQ(0u, getMetrics(OperationType::pageTableWalk).count);
+
+    registry.enable(true);
+    {
+        ScopedOperationTimer timer(OperationType::pageTableWalk, 4096);
+        timer.setBytes(8192);
+    }
+    auto metrics = getMetrics(OperationType::pageTableWalk);
+    EXPECT_EQ(1u, metrics.count);
+    EXPECT_EQ(8192u, metrics.bytes);
+}
+
+TEST_F(MetricsRegistryTest, givenConcurrentRecordsWhenMetricsAreQueriedThenNoUpdatesAreLost) {
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (uint64_t i = 0; i < 1000; i++) {
+                registry.record(OperationType::submitBatchBuffer, 1, t * 1000 + i);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto metrics = getMetrics(OperationType::submitBatchBuffer);
+    EXPECT_EQ(4000u, metrics.count);
+    EXPECT_EQ(4000u, metrics.bytes);
+    EXPECT_EQ(3999u, metrics.maxNanoseconds);
+}
+
+TEST_F(MetricsRegistryTest, givenRecordedOperationWhenJsonIsCreatedThenAllOperationsAreListed) {
+    registry.record(OperationType::writeMemory2, 4096, 2);
+
+    auto json = registry.toJson();
+    EXPECT_NE(std::string::npos, json.find("{\"name\": \"writeMemory2\", \"count\": 1, \"bytes\": 4096, \"totalNanoseconds\": 2, \"maxNanoseconds\": 2, \"latencyHistogram\": [0, 1, 0"));
+    for (uint32_t i = 0; i < static_cast<uint32_t>(OperationType::count); i++) {
+        EXPECT_NE(std::string::npos, json.find(MetricsRegistry::getOperationName(static_cast<OperationType>(i))));
+    }
+}
@@ -20,6 +20,8 @@ template <>
 struct WhiteBox<AubFileStream> : public AubFileStream {
     using AubStream::dumpBinSupported;
     using AubStream::dumpSurfaceSupported;
+    using AubFileStream::writeContiguousPages;
+    using AubFileStream::writeDiscontiguousPages;
     WhiteBox() : AubFileStream() {}
 };
 
@@ -121,6 +123,7 @@ struct MockTbxShmStream : public TbxShmStream {
     MockTbxShmStream(uint32_t mode) : TbxShmStream(mode) {}
     bool baseInit(TranslatePhysicalAddressToSystemMemoryFn fn) { return TbxShmStream::init(fn); }
     void baseWriteContiguousPages(const void *memory, size_t size, uint64_t physAddress, int addressSpace, int hint) { TbxShmStream::writeContiguousPages(memory, size, physAddress, addressSpace, hint); }
+    void baseMemoryPoll(const std::vector<PageInfo> &entries, uint32_t value, uint32_t compareMode) { TbxShmStream::memoryPoll(entries, value, compareMode); }
     MOCK_METHOD2(init, bool(int steppingValue, const GpuDescriptor &gpu));
     MOCK_METHOD1(addComment, void(const char *message));
 
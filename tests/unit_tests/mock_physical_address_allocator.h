@@ -15,6 +15,7 @@ template <typename AddressType>
 struct MockSimpleAllocator : public SimpleAllocator<AddressType> {
     using BaseClass = SimpleAllocator<AddressType>;
     using BaseClass::freeAllocationsMap;
+    using BaseClass::mutex;
     using BaseClass::nextAddress;
     using BaseClass::usedAllocationsMap;
 
@@ -43,6 +44,7 @@ struct MockPhysicalAddressAllocatorSimple : public PhysicalAddressAllocatorSimpl
     }
 
     using PhysicalAddressAllocatorSimple::allocators;
+    using PhysicalAddressAllocatorSimple::getThreadMagazines;
     using PhysicalAddressAllocatorSimple::mainAllocator;
     using PhysicalAddressAllocatorSimple::numberOfAllocators;
 };
@@ -51,7 +53,10 @@ struct MockPhysicalAddressAllocatorHeap : public PhysicalAddressAllocatorHeap {
     MockPhysicalAddressAllocatorHeap() : PhysicalAddressAllocatorHeap() {
     }
 
-    using PhysicalAddressAllocatorHeap::storage;
+    using PhysicalAddressAllocatorHeap::chunks;
+    using PhysicalAddressAllocatorHeap::freeBlocks;
+    using PhysicalAddressAllocatorHeap::largeBlocks;
+    using PhysicalAddressAllocatorHeap::liveBlocks;
 };
 
 struct MockPhysicalAddressAllocatorSimpleAndSHM4Mapper : public PhysicalAddressAllocatorSimpleAndSHM4Mapper {
@@ -15,6 +15,7 @@ struct MockTbxSocketsImp : public TbxSocketsImp {
     using TbxSocketsImp::checkServerConfig;
     using TbxSocketsImp::frontdoorMode;
     using TbxSocketsImp::inErrorState;
+    using TbxSocketsImp::sendBufferSize;
 
   public:
     MOCK_METHOD4(readMemoryExt, bool(uint64_t offset, void *data, size_t size, bool isLocalMem));
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/occupancy_bitmap.h"
+#include "aub_mem_dump/page_table.h"
+#include "test_defaults.h"
+
+#include "gtest/gtest.h"
+
+using namespace aub_stream;
+
+TEST(OccupancyBitmap, givenEntriesSetAndResetWhenCountIsQueriedThenOnlyPresentEntriesAreCounted) {
+    OccupancyBitmap bitmap(512);
+    EXPECT_TRUE(bitmap.none());
+
+    bitmap.set(0);
+    bitmap.set(63);
+    bitmap.set(64);
+    bitmap.set(64);
+    bitmap.set(511);
+    EXPECT_EQ(4u, bitmap.count());
+    EXPECT_TRUE(bitmap.test(63));
+    EXPECT_FALSE(bitmap.test(62));
+
+    bitmap.reset(64);
+    bitmap.reset(64);
+    bitmap.reset(100);
+    EXPECT_EQ(3u, bitmap.count());
+
+    bitmap.reset(0);
+    bitmap.reset(63);
+    bitmap.reset(511);
+    EXPECT_TRUE(bitmap.none());
+}
+
+TEST(OccupancyBitmap, givenSparseEntriesWhenFindNextIsCalledThenNextPresentEntryIsReturned) {
+    OccupancyBitmap bitmap(512);
+    EXPECT_EQ(OccupancyBitmap::npos, bitmap.findNext(0));
+
+    bitmap.set(5);
+    bitmap.set(200);
+    bitmap.set(511);
+
+    EXPECT_EQ(5u, bitmap.findNext(0));
+    EXPECT_EQ(5u, bitmap.findNext(5));
+    EXPECT_EQ(200u, bitmap.findNext(6));
+    EXPECT_EQ(511u, bitmap.findNext(201));
+    EXPECT_EQ(OccupancyBitmap::npos, bitmap.findNext(512));
+}
+
+TEST(OccupancyBitmap, givenRangeWhenCountInRangeIsCalledThenPresentEntriesInRangeAreCounted) {
+    OccupancyBitmap bitmap(512);
+    for (size_t i = 60; i < 140; i++) {
+        bitmap.set(i);
+    }
+
+    EXPECT_EQ(80u, bitmap.countInRange(0, 512));
+    EXPECT_EQ(4u, bitmap.countInRange(0, 64));
+    EXPECT_EQ(64u, bitmap.countInRange(64, 128));
+    EXPECT_EQ(10u, bitmap.countInRange(130, 140));
+    EXPECT_EQ(0u, bitmap.countInRange(140, 512));
+}
+
+TEST(OccupancyBitmap, givenGrowingTableWhenResizedThenPresentEntriesAreKept) {
+    OccupancyBitmap bitmap;
+    bitmap.resize(10);
+    bitmap.set(9);
+
+    bitmap.resize(1u << 20);
+    bitmap.set((1u << 20) - 1);
+    EXPECT_TRUE(bitmap.test(9));
+    EXPECT_EQ(2u, bitmap.count());
+    EXPECT_EQ((1u << 20) - 1, bitmap.findNext(10));
+}
+
+TEST(OccupancyBitmap, givenPteWhenLeavesAreMappedAndReleasedThenEmptinessAndNextLeafFollow) {
+    PhysicalAddressAllocatorSimple allocator;
+    PTE4KB pte(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    EXPECT_TRUE(pte.isEmpty());
+
+    pte.allocateLeaf(3, MEMORY_BANK_SYSTEM, {});
+    pte.setLeaf(300, 0x200000, MEMORY_BANK_SYSTEM, {});
+    EXPECT_FALSE(pte.isEmpty());
+    EXPECT_EQ(3u, pte.findNextLeaf(0));
+    EXPECT_EQ(300u, pte.findNextLeaf(4));
+
+    pte.releaseLeaf(3);
+    EXPECT_EQ(300u, pte.findNextLeaf(0));
+
+    pte.releaseLeaf(300);
+    EXPECT_TRUE(pte.isEmpty());
+}
+
+TEST(OccupancyBitmap, givenPdeWhenChildrenAreSetAndClearedThenEmptinessFollows) {
+    PhysicalAddressAllocatorSimple allocator;
+    PDE pde(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    EXPECT_TRUE(pde.isEmpty());
+
+    auto child = pde.allocateChild(*gpu, 4096, MEMORY_BANK_SYSTEM);
+    pde.setChild(511, child);
+    EXPECT_FALSE(pde.isEmpty());
+    EXPECT_EQ(511u, pde.findNextChild(0));
+
+    pde.setChild(511, nullptr);
+    EXPECT_TRUE(pde.isEmpty());
+    pde.getArena().destroy(child);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "aub_mem_dump/hash_helpers.h"
+#include "aub_mem_dump/page_content_cache.h"
+#include "aub_mem_dump/aub_stream.h"
+
+using namespace aub_stream;
+
+TEST(HashHelpers, givenKnownInputsWhenXxHash64IsCalledThenReferenceValuesAreReturned) {
+    EXPECT_EQ(0xEF46DB3751D8E999ull, xxHash64("", 0));
+    EXPECT_EQ(0xD24EC4F1A98C6E5Bull, xxHash64("a", 1));
+    EXPECT_EQ(0x44BC2CF5AD770999ull, xxHash64("abc", 3));
+    EXPECT_EQ(0xFBCEA83C8A378BF1ull, xxHash64("Nobody inspects the spammish repetition", 39));
+}
+
+TEST(PageContentCache, givenEntryCountWhenCacheIsCreatedThenItIsRoundedUpToPowerOfTwo) {
+    EXPECT_EQ(2u, PageContentCache(0).getEntryCount());
+    EXPECT_EQ(2u, PageContentCache(2).getEntryCount());
+    EXPECT_EQ(1024u, PageContentCache(1000).getEntryCount());
+}
+
+TEST(PageContentCache, givenPageWhenUpdatedWithSameHashThenItIsReportedUnchanged) {
+    PageContentCache cache(64);
+
+    EXPECT_FALSE(cache.update(0x10000, AddressSpaceValues::TraceLocal, 0x1234));
+    EXPECT_TRUE(cache.update(0x10000, AddressSpaceValues::TraceLocal, 0x1234));
+    EXPECT_FALSE(cache.update(0x10000, AddressSpaceValues::TraceLocal, 0x5678));
+    EXPECT_TRUE(cache.update(0x10000, AddressSpaceValues::TraceLocal, 0x5678));
+
+    EXPECT_FALSE(cache.update(0x10000, AddressSpaceValues::TraceNonlocal, 0x5678));
+    EXPECT_FALSE(cache.update(0x11000, AddressSpaceValues::TraceLocal, 0x5678));
+}
+
+TEST(PageContentCache, givenPartialWriteWhenInvalidateIsCalledThenOverlappedPagesAreForgotten) {
+    PageContentCache cache(64);
+    for (uint64_t page = 0x10000; page < 0x14000; page += PageContentCache::pageSize) {
+        cache.update(page, AddressSpaceValues::TraceLocal, page);
+    }
+
+    cache.invalidate(0x11ff8, 16, AddressSpaceValues::TraceLocal);
+    cache.invalidate(0x13000, 8, AddressSpaceValues::TraceNonlocal);
+
+    EXPECT_TRUE(cache.update(0x10000, AddressSpaceValues::TraceLocal, 0x10000));
+    EXPECT_FALSE(cache.update(0x11000, AddressSpaceValues::TraceLocal, 0x11000));
+    EXPECT_FALSE(cache.update(0x12000, AddressSpaceValues::TraceLocal, 0x12000));
+    EXPECT_TRUE(cache.update(0x13000, AddressSpaceValues::TraceLocal, 0x13000));
+}
+
+TEST(PageContentCache, givenMorePagesThanEntriesWhenUpdatedThenCacheStaysBoundedAndEvictedPagesAreReportedChanged) {
+    PageContentCache cache(4);
+    size_t unchangedCount = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint64_t page = 0; page < 64 * PageContentCache::pageSize; page += PageContentCache::pageSize) {
+            unchangedCount += cache.update(page, AddressSpaceValues::TraceLocal, page) ? 1 : 0;
+        }
+    }
+    EXPECT_EQ(4u, cache.getEntryCount());
+    EXPECT_LE(unchangedCount, 4u);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/page_table.h"
+#include "aub_mem_dump/page_table_arena.h"
+#include "aub_mem_dump/page_table_walker.h"
+#include "mock_aub_stream.h"
+#include "test_defaults.h"
+
+#include "gtest/gtest.h"
+
+using namespace aub_stream;
+
+namespace {
+
+struct CountingPhysicalAddressAllocator : public PhysicalAddressAllocatorSimple {
+    uint64_t reservePhysicalMemory(uint32_t memoryBank, size_t size, size_t alignment) override {
+        reserveCount++;
+        return PhysicalAddressAllocatorSimple::reservePhysicalMemory(memoryBank, size, alignment);
+    }
+
+    void freePhysicalMemory(uint32_t memoryBank, uint64_t address) override {
+        freeCount++;
+        PhysicalAddressAllocatorSimple::freePhysicalMemory(memoryBank, address);
+    }
+
+    size_t reserveCount = 0;
+    size_t freeCount = 0;
+};
+
+struct PageTableArenaTest : public MockAubStreamFixture, public ::testing::Test {
+    void SetUp() override { MockAubStreamFixture::SetUp(); }
+    void TearDown() override { MockAubStreamFixture::TearDown(); }
+};
+
+} // namespace
+
+TEST_F(PageTableArenaTest, givenDestroyedNodeWhenNodeIsCreatedThenSlotIsReused) {
+    PhysicalAddressAllocatorSimple allocator;
+    PageTableArena arena;
+
+    auto node0 = arena.create<PTE4KB>(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    auto node1 = arena.create<PDE>(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    EXPECT_EQ(2u, arena.getLiveNodeCount());
+    EXPECT_EQ(1u, arena.getSlabCount());
+    EXPECT_EQ(&arena, &node0->getArena());
+
+    for (PageTable *node : {static_cast<PageTable *>(node0), static_cast<PageTable *>(node1)}) {
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(node) % PageTableArena::cacheLineSize);
+    }
+
+    arena.destroy(node0);
+    EXPECT_EQ(1u, arena.getLiveNodeCount());
+
+    auto node2 = arena.create<PTE64KB>(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    EXPECT_EQ(static_cast<void *>(node0), static_cast<void *>(node2));
+    EXPECT_EQ(2u, arena.getLiveNodeCount());
+}
+
+TEST_F(PageTableArenaTest, givenMoreNodesThanSlabSlotsWhenArenaIsReleasedThenAllNodesAreDestroyed) {
+    CountingPhysicalAddressAllocator allocator;
+    PageTableArena arena;
+
+    const size_t nodeCount = 2 * PageTableArena::slotsPerSlab + 1;
+    for (size_t i = 0; i < nodeCount; i++) {
+        arena.create<PDE>(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    }
+    EXPECT_EQ(nodeCount, arena.getLiveNodeCount());
+    EXPECT_EQ(3u, arena.getSlabCount());
+
+    arena.releaseAll();
+    EXPECT_EQ(0u, arena.getLiveNodeCount());
+    EXPECT_EQ(0u, arena.getSlabCount());
+    EXPECT_EQ(allocator.reserveCount, allocator.freeCount);
+}
+
+TEST_F(PageTableArenaTest, givenMappedRangeWhenPpgttIsDestroyedThenEveryNodeAndPageIsReleased) {
+    CountingPhysicalAddressAllocator allocator;
+    {
+        PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+        PageTableWalker walker;
+        walker.walkMemory(&ppgtt, {0x100000000ull, nullptr, 8 * MB, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr);
+
+        // PDP, PDE and 4 PTEs covering 8MB of 4KB pages
+        EXPECT_EQ(6u, ppgtt.getArena().getLiveNodeCount());
+    }
+    EXPECT_EQ(allocator.reserveCount, allocator.freeCount);
+}
+
+TEST_F(PageTableArenaTest, givenMappedRangeWhenFreedThenEmptyTablesReturnToArena) {
+    PhysicalAddressAllocatorSimple allocator;
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    const uint64_t gfxAddress = 0x100000000ull;
+    {
+        PageTableWalker walker;
+        walker.walkMemory(&ppgtt, {gfxAddress, nullptr, 4 * MB, MEMORY_BANK_SYSTEM, 0, 65536}, PageTableWalker::WalkMode::Reserve, nullptr);
+    }
+    EXPECT_EQ(4u, ppgtt.getArena().getLiveNodeCount());
+
+    stream.AubStream::freeMemory(&ppgtt, gfxAddress, 4 * MB);
+
+    // Emptied PTEs are destroyed, the PDP and PDE are kept
+    EXPECT_EQ(2u, ppgtt.getArena().getLiveNodeCount());
+}
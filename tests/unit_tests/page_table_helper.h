@@ -13,14 +13,18 @@
 
 struct PageTableHelper {
     static inline uint64_t getPhysicalAddress(aub_stream::PageTable *ppgtt, uint64_t gfxAddress) {
-        aub_stream::PageTable *pageTable = ppgtt->getChild(ppgtt->getIndex(gfxAddress));
+        if (auto ggtt = dynamic_cast<aub_stream::GGTT *>(ppgtt)) {
+            return ggtt->getEntry(ggtt->getIndex(gfxAddress)) & aub_stream::GGTT::physicalAddressMask;
+        }
+        aub_stream::PageTable *pageTable = getLeafParent(ppgtt, gfxAddress);
+        EXPECT_NE(nullptr, pageTable);
 
-        auto levels = ppgtt->getNumLevels() - 1;
-        while (levels-- > 0) {
-            EXPECT_NE(nullptr, pageTable);
-            pageTable = pageTable->getChild(pageTable->getIndex(gfxAddress));
+        if (auto pte = dynamic_cast<aub_stream::PTE *>(pageTable)) {
+            auto leaf = pte->getLeaf(pte->getIndex(gfxAddress));
+            return leaf ? leaf->getPhysicalAddress() : 0;
         }
 
+        pageTable = pageTable ? pageTable->getChild(pageTable->getIndex(gfxAddress)) : nullptr;
         if (pageTable) {
             return pageTable->getPhysicalAddress();
         }
@@ -28,14 +32,18 @@ struct PageTableHelper {
     }
 
     static inline uint64_t getEntry(aub_stream::PageTable *ppgtt, uint64_t gfxAddress) {
-        aub_stream::PageTable *pageTable = ppgtt->getChild(ppgtt->getIndex(gfxAddress));
+        if (auto ggtt = dynamic_cast<aub_stream::GGTT *>(ppgtt)) {
+            return ggtt->getEntry(ggtt->getIndex(gfxAddress));
+        }
+        aub_stream::PageTable *pageTable = getLeafParent(ppgtt, gfxAddress);
+        EXPECT_NE(nullptr, pageTable);
 
-        auto levels = ppgtt->getNumLevels() - 1;
-        while (levels-- > 0) {
-            EXPECT_NE(nullptr, pageTable);
-            pageTable = pageTable->getChild(pageTable->getIndex(gfxAddress));
+        if (auto pte = dynamic_cast<aub_stream::PTE *>(pageTable)) {
+            auto index = pte->getIndex(gfxAddress);
+            return pte->getLeaf(index) ? pte->getLeafEntryValue(index) : 0;
         }
 
+        pageTable = pageTable ? pageTable->getChild(pageTable->getIndex(gfxAddress)) : nullptr;
         if (pageTable) {
             return pageTable->getEntryValue();
         }
@@ -43,18 +51,27 @@ struct PageTableHelper {
     }
 
     static inline uint64_t getPTEEntry(aub_stream::PageTable *ppgtt, uint64_t gfxAddress) {
+        aub_stream::PageTable *pageTable = getLeafParent(ppgtt, gfxAddress);
+
+        if (pageTable) {
+            return pageTable->getEntryValue();
+        }
+        return 0;
+    }
+
+    // Returns the table holding the leaf entry of gfxAddress, PTE leaves are packed entries rather than children
+    static inline aub_stream::PageTable *getLeafParent(aub_stream::PageTable *ppgtt, uint64_t gfxAddress) {
         aub_stream::PageTable *pageTable = ppgtt;
 
         auto levels = ppgtt->getNumLevels() - 1;
         while (levels > 0) {
             EXPECT_NE(nullptr, pageTable);
+            if (!pageTable) {
+                return nullptr;
+            }
             pageTable = pageTable->getChild(pageTable->getIndex(gfxAddress));
             levels--;
         }
-
-        if (pageTable) {
-            return pageTable->getEntryValue();
-        }
-        return 0;
+        return pageTable;
     }
 };
@@ -71,11 +71,11 @@ TEST(PML5, GivenHBMTableAndSystemLastLevelPageWalkPageTables) {
     ASSERT_NE(nullptr, pde);
     EXPECT_TRUE(pde->isLocalMemory());
 
-    auto pte = pde->getChild(0);
+    auto pte = static_cast<PTE *>(pde->getChild(0));
     ASSERT_NE(nullptr, pte);
     EXPECT_TRUE(pte->isLocalMemory());
 
-    auto page = pte->getChild(0);
+    auto page = pte->getLeaf(0);
     ASSERT_NE(nullptr, page);
     EXPECT_FALSE(page->isLocalMemory());
 }
@@ -138,12 +138,20 @@ TEST(GGTT, getIndex) {
     EXPECT_EQ(0xdeadf, pageTable.getIndex(address));
 }
 
-TEST(GGTT, allocateChildReturnsNonNullPointer) {
+TEST(GGTT, mapPageFillsOneEntryPerPhysicallyContiguous4KB) {
     PhysicalAddressAllocatorSimple allocator;
     GGTT pageTable(*gpu, &allocator, MEMORY_BANK_0);
-    auto child = pageTable.allocateChild(*gpu, pageTable.getPageSize(), pageTable.getMemoryBank());
-    EXPECT_NE(nullptr, child);
-    delete child;
+    auto entries = pageTable.mapPage(16, 65536, true);
+    ASSERT_NE(nullptr, entries);
+
+    auto physicalAddress = entries[0] & GGTT::physicalAddressMask;
+    EXPECT_EQ(0u, physicalAddress & 0xffff);
+    for (auto i = 0u; i < 16u; i++) {
+        EXPECT_EQ((physicalAddress + i * 4096) | toBitValue(GGTT::validBit, GGTT::localMemoryBit), entries[i]);
+        EXPECT_EQ(entries[i], pageTable.getEntry(16 + i));
+    }
+    EXPECT_EQ(0u, pageTable.getEntry(15));
+    EXPECT_EQ(0u, pageTable.getEntry(32));
 }
 
 TEST_P(GGTTTest, ctor) {
@@ -208,7 +216,7 @@ TEST(PDP4, allocateChildReturnsNonNullPointer) {
     PDP4 pageTable(*gpu, &allocator, MEMORY_BANK_0);
     auto child = pageTable.allocateChild(*gpu, 4096, pageTable.getMemoryBank());
     EXPECT_NE(nullptr, child);
-    delete child;
+    pageTable.getArena().destroy(child);
 }
 
 TEST_P(PDP4Test, ctor) {
@@ -285,6 +293,40 @@ TEST(PTE4KB, getIndex) {
     EXPECT_EQ(511u, pageTable.getIndex(0xffffffffffff));
 }
 
+TEST(PTE4KB, givenTrackedPs64GroupsWhenGroupIsFilledRemappedAndReleasedThenCompletenessFollows) {
+    PhysicalAddressAllocatorSimple allocator;
+    PTE4KB pageTable(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    const AllocationParams::AdditionalParams additionalParams = {};
+    const uint64_t base = 0x100000;
+
+    // Slot 0 is filled last so both the per-slot and the whole-group update paths are used
+    for (unsigned int i = 17; i < 32; i++) {
+        pageTable.setLeaf(i, base + (i - 16) * 4096, MEMORY_BANK_SYSTEM, additionalParams);
+    }
+    pageTable.trackPs64Groups();
+    EXPECT_FALSE(pageTable.isPs64GroupComplete(16));
+
+    pageTable.setLeaf(16, base, MEMORY_BANK_SYSTEM, additionalParams);
+    EXPECT_TRUE(pageTable.isPs64GroupComplete(16));
+    EXPECT_TRUE(pageTable.isPs64GroupComplete(31));
+    EXPECT_FALSE(pageTable.isPs64GroupComplete(0));
+    EXPECT_FALSE(pageTable.isPs64GroupComplete(32));
+
+    pageTable.getLeaf(20)->setPhysicalAddress(base + 0x10000);
+    pageTable.updatePs64Group(20);
+    EXPECT_FALSE(pageTable.isPs64GroupComplete(16));
+
+    pageTable.getLeaf(20)->setPhysicalAddress(base + 4 * 4096);
+    pageTable.updatePs64Group(20);
+    EXPECT_TRUE(pageTable.isPs64GroupComplete(16));
+
+    pageTable.releaseLeaf(16);
+    EXPECT_FALSE(pageTable.isPs64GroupComplete(16));
+
+    pageTable.setLeaf(16, base + 0x1000, MEMORY_BANK_SYSTEM, additionalParams);
+    EXPECT_FALSE(pageTable.isPs64GroupComplete(16));
+}
+
 TEST_P(PTE4KBTest, ctor) {
     PhysicalAddressAllocatorSimple allocator;
     PTE4KB pageTable(*gpu, &allocator, memoryBank);
@@ -371,11 +413,11 @@ TEST_F(PageTableTest, GivenHBMTableAndSystemLastLevelPageVerifyMemoryLocation) {
     ASSERT_NE(nullptr, pde);
     EXPECT_TRUE(pde->isLocalMemory());
 
-    auto pte = pde->getChild(0);
+    auto pte = static_cast<PTE *>(pde->getChild(0));
     ASSERT_NE(nullptr, pte);
     EXPECT_TRUE(pte->isLocalMemory());
 
-    auto page = pte->getChild(0);
+    auto page = pte->getLeaf(0);
     ASSERT_NE(nullptr, page);
     EXPECT_FALSE(page->isLocalMemory());
 }
@@ -400,12 +442,12 @@ TEST_F(PageTableTest, givenMemoryPropertyWhenWriteCalledThenApplyPageProperties)
     EXPECT_FALSE(pde->peekAllocationParams().compressionEnabled);
     EXPECT_FALSE(pde->peekAllocationParams().uncached);
 
-    auto pte = pde->getChild(0);
+    auto pte = static_cast<PTE *>(pde->getChild(0));
     ASSERT_NE(nullptr, pte);
     EXPECT_FALSE(pte->peekAllocationParams().compressionEnabled);
     EXPECT_FALSE(pte->peekAllocationParams().uncached);
 
-    auto page = pte->getChild(0);
+    auto page = pte->getLeaf(0);
     ASSERT_NE(nullptr, page);
     EXPECT_TRUE(page->peekAllocationParams().compressionEnabled);
     EXPECT_FALSE(page->peekAllocationParams().uncached);
@@ -518,11 +560,10 @@ TEST_F(PageTableTest, GivenHBMGGTTAubStreamWriteMemoryVerifyChildPageAttributes)
     uint32_t data = 0xabcdabcd;
     stream.writeMemory(&ggtt, 0, &data, sizeof(data), MEMORY_BANK_0, DataTypeHintValues::TraceNotype, 4096);
 
-    auto child = ggtt.getChild(0);
-    ASSERT_NE(nullptr, child);
-    EXPECT_NE(0u, child->getPhysicalAddress());
-    EXPECT_EQ(ggtt.getMemoryBank(), child->getMemoryBank());
-    EXPECT_TRUE(child->isLocalMemory());
+    auto entry = ggtt.getEntry(0);
+    EXPECT_NE(0u, entry & toBitValue(GGTT::validBit));
+    EXPECT_NE(0u, entry & GGTT::physicalAddressMask);
+    EXPECT_NE(0u, entry & toBitValue(GGTT::localMemoryBit));
 }
 
 TEST_F(PageTableTest, GivenSystemmemGGTTAubStreamWriteMemoryVerifyChildPageAttributes) {
@@ -532,11 +573,10 @@ TEST_F(PageTableTest, GivenSystemmemGGTTAubStreamWriteMemoryVerifyChildPageAttri
     uint32_t data = 0xabcdabcd;
     stream.writeMemory(&ggtt, 0, &data, sizeof(data), MEMORY_BANK_SYSTEM, DataTypeHintValues::TraceNotype, 4096);
 
-    auto child = ggtt.getChild(0);
-    ASSERT_NE(nullptr, child);
-    EXPECT_NE(0u, child->getPhysicalAddress());
-    EXPECT_EQ(ggtt.getMemoryBank(), child->getMemoryBank());
-    EXPECT_FALSE(child->isLocalMemory());
+    auto entry = ggtt.getEntry(0);
+    EXPECT_NE(0u, entry & toBitValue(GGTT::validBit));
+    EXPECT_NE(0u, entry & GGTT::physicalAddressMask);
+    EXPECT_EQ(0u, entry & toBitValue(GGTT::localMemoryBit));
 }
 
 TEST_F(PageTableTest, GivenHBMGGTTExpectMemoryVerifyExpectMemoryTableGetsCalled) {
@@ -560,7 +600,7 @@ TEST(PageTable, unusedVirtualMethods) {
     EXPECT_EQ(0, pageTable.getIndex(physicalAddress));
 }
 
-TEST(PageTable, PageTableStorageResizedOnSetChildCallInsteadOfConstructor) {
+TEST(PageTable, givenInteriorTableWhenConstructedThenChildStorageIsFixedSize) {
     struct MockPageTable : PageTable {
         using PageTable::PageTable;
         using PageTable::table;
@@ -569,6 +609,23 @@ TEST(PageTable, PageTableStorageResizedOnSetChildCallInsteadOfConstructor) {
     PhysicalAddressAllocatorSimple allocator;
 
     MockPageTable pageTable(*gpu, &allocator, 4096u, 512u, MEMORY_BANK_SYSTEM);
+    EXPECT_EQ(512u, pageTable.table.size());
+    EXPECT_EQ(nullptr, pageTable.getChild(2u));
+    EXPECT_TRUE(pageTable.isEmpty());
+
+    pageTable.setChild(511u, nullptr);
+    EXPECT_EQ(512u, pageTable.table.size());
+}
+
+TEST(PageTable, givenGgttSizedTableWhenSetChildIsCalledThenStorageIsResizedInsteadOfConstructor) {
+    struct MockPageTable : PageTable {
+        using PageTable::PageTable;
+        using PageTable::table;
+    };
+
+    PhysicalAddressAllocatorSimple allocator;
+
+    MockPageTable pageTable(*gpu, &allocator, 0u, 1u << 20, MEMORY_BANK_SYSTEM);
     EXPECT_EQ(0u, pageTable.table.size());
     auto child = pageTable.getChild(2u);
     EXPECT_EQ(nullptr, child);
@@ -587,7 +644,8 @@ TEST(PageTable, whenPageTableIsDeletedThenFreePhysicalMemory) {
         EXPECT_EQ(pMockAllocator->freeAllocationsMap.size(), 0);
     }
     EXPECT_EQ(pMockAllocator->usedAllocationsMap.size(), 0);
-    EXPECT_EQ(pMockAllocator->freeAllocationsMap.size(), 1);
+    EXPECT_EQ(pMockAllocator->freeAllocationsMap.size(), 0);
+    EXPECT_EQ(reservedGGTTSpace, pMockAllocator->nextAddress);
 }
 
 TEST(PageTable, getPageSizeReturnsZeroForNonLeafNodes) {
@@ -671,7 +729,7 @@ INSTANTIATE_TEST_SUITE_P(Page2MB,
 TEST(PDE, allocateChildReturns2MBPageWhenPageSize2MB) {
     PhysicalAddressAllocatorSimple allocator;
     PDE pde(*gpu, &allocator, MEMORY_BANK_0);
-    std::unique_ptr<PageTable> child(pde.allocateChild(*gpu, Page2MB::pageSize2MB, pde.getMemoryBank()));
+    auto child = pde.allocateChild(*gpu, Page2MB::pageSize2MB, pde.getMemoryBank());
     ASSERT_NE(nullptr, child);
     EXPECT_EQ(Page2MB::pageSize2MB, child->getPageSize());
 }
@@ -679,7 +737,7 @@ TEST(PDE, allocateChildReturns2MBPageWhenPageSize2MB) {
 TEST(PDE, allocateChildReturns4KBPTEWhenPageSize4KB) {
     PhysicalAddressAllocatorSimple allocator;
     PDE pde(*gpu, &allocator, MEMORY_BANK_0);
-    std::unique_ptr<PageTable> child(pde.allocateChild(*gpu, 4096, pde.getMemoryBank()));
+    auto child = pde.allocateChild(*gpu, 4096, pde.getMemoryBank());
     ASSERT_NE(nullptr, child);
     EXPECT_EQ(4096u, child->getPageSize());
 }
@@ -687,7 +745,7 @@ TEST(PDE, allocateChildReturns4KBPTEWhenPageSize4KB) {
 TEST(PDE, allocateChildReturns64KBPTEWhenPageSize64KB) {
     PhysicalAddressAllocatorSimple allocator;
     PDE pde(*gpu, &allocator, MEMORY_BANK_0);
-    std::unique_ptr<PageTable> child(pde.allocateChild(*gpu, 65536, pde.getMemoryBank()));
+    auto child = pde.allocateChild(*gpu, 65536, pde.getMemoryBank());
     ASSERT_NE(nullptr, child);
     EXPECT_EQ(65536u, child->getPageSize());
 }
@@ -866,7 +924,7 @@ TEST(PDE, allocateChildReturns2MBPageWhenPageSize2MBWithAdditionalParams) {
     AllocationParams::AdditionalParams additionalParams = {};
     additionalParams.compressionEnabled = true;
 
-    std::unique_ptr<PageTable> child(pde.allocateChild(*gpu, Page2MB::pageSize2MB, MEMORY_BANK_0, additionalParams));
+    auto child = pde.allocateChild(*gpu, Page2MB::pageSize2MB, MEMORY_BANK_0, additionalParams);
     ASSERT_NE(nullptr, child);
     EXPECT_EQ(Page2MB::pageSize2MB, child->getPageSize());
     EXPECT_TRUE(child->peekAllocationParams().compressionEnabled);
@@ -880,7 +938,7 @@ TEST(PDE, allocateChildReturns2MBPageWhenPageSize2MBWithAdditionalParamsAndPhysi
     additionalParams.compressionEnabled = true;
     uint64_t physicalAddress = 0x400000; // 2MB aligned
 
-    std::unique_ptr<PageTable> child(pde.allocateChild(*gpu, Page2MB::pageSize2MB, MEMORY_BANK_0, additionalParams, physicalAddress));
+    auto child = pde.allocateChild(*gpu, Page2MB::pageSize2MB, MEMORY_BANK_0, additionalParams, physicalAddress);
     ASSERT_NE(nullptr, child);
     EXPECT_EQ(Page2MB::pageSize2MB, child->getPageSize());
     EXPECT_EQ(physicalAddress, child->getPhysicalAddress());
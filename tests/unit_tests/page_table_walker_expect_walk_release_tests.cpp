@@ -34,12 +34,12 @@ TEST_F(ExpectWalkReleaseTest, givenUnmappedGgttAddressWhenReadMemoryThenNoGttNod
 
     const uint64_t gfxAddress = 0x1000;
     const auto index = ggtt.getIndex(static_cast<uint32_t>(gfxAddress));
-    ASSERT_EQ(nullptr, ggtt.getChild(index));
+    ASSERT_EQ(0u, ggtt.getEntry(index));
 
     uint8_t buf[pageSize4K] = {};
     stream.AubStream::readMemory(&ggtt, gfxAddress, buf, sizeof(buf), MEMORY_BANK_SYSTEM, pageSize4K);
 
-    EXPECT_EQ(nullptr, ggtt.getChild(index));
+    EXPECT_EQ(0u, ggtt.getEntry(index));
 }
 
 TEST_F(ExpectWalkReleaseTest, givenCompletelyUnmappedPpgttWhenReadMemoryThenNoNodesCreated) {
@@ -102,14 +102,14 @@ TEST_F(ExpectWalkReleaseTest, givenMissingDataPageWhenReadMemoryThenNoDataPageCr
     ASSERT_NE(nullptr, pdp);
     auto *pde = pdp->getChild(pdp->getIndex(gfxAddress));
     ASSERT_NE(nullptr, pde);
-    auto *pte = pde->getChild(pde->getIndex(gfxAddress));
+    auto *pte = static_cast<PTE *>(pde->getChild(pde->getIndex(gfxAddress)));
     ASSERT_NE(nullptr, pte);
-    ASSERT_EQ(nullptr, pte->getChild(pte->getIndex(gfxAddress)));
+    ASSERT_EQ(nullptr, pte->getLeaf(pte->getIndex(gfxAddress)));
 
     uint8_t buf[pageSize4K] = {};
     stream.AubStream::readMemory(&ppgtt, gfxAddress, buf, sizeof(buf), MEMORY_BANK_SYSTEM, 65536);
 
-    EXPECT_EQ(nullptr, pte->getChild(pte->getIndex(gfxAddress)));
+    EXPECT_EQ(nullptr, pte->getLeaf(pte->getIndex(gfxAddress)));
 }
 
 TEST_F(ExpectWalkReleaseTest, givenPartiallyMappedRangeWhenReadMemoryThenUnmappedSlotRemainsNull) {
@@ -122,14 +122,14 @@ TEST_F(ExpectWalkReleaseTest, givenPartiallyMappedRangeWhenReadMemoryThenUnmappe
     ASSERT_NE(nullptr, pdp);
     auto *pde = pdp->getChild(pdp->getIndex(0x101000));
     ASSERT_NE(nullptr, pde);
-    auto *pte = pde->getChild(pde->getIndex(0x101000));
+    auto *pte = static_cast<PTE *>(pde->getChild(pde->getIndex(0x101000)));
     ASSERT_NE(nullptr, pte);
-    ASSERT_EQ(nullptr, pte->getChild(pte->getIndex(0x101000)));
+    ASSERT_EQ(nullptr, pte->getLeaf(pte->getIndex(0x101000)));
 
     uint8_t buf[2 * pageSize4K] = {};
     stream.AubStream::readMemory(&ppgtt, 0x100000, buf, sizeof(buf), MEMORY_BANK_SYSTEM, pageSize4K);
 
-    EXPECT_EQ(nullptr, pte->getChild(pte->getIndex(0x101000)));
+    EXPECT_EQ(nullptr, pte->getLeaf(pte->getIndex(0x101000)));
 }
 
 TEST_F(ExpectWalkReleaseTest, givenUnmappedPpgttWith4KbPagesWhenReadMemoryThenNoNodesCreated) {
@@ -156,14 +156,14 @@ TEST_F(ExpectWalkReleaseTest, givenMissing4KbDataPageWhenReadMemoryThenNoDataPag
     ASSERT_NE(nullptr, pdp);
     auto *pde = pdp->getChild(pdp->getIndex(gfxAddress));
     ASSERT_NE(nullptr, pde);
-    auto *pte = pde->getChild(pde->getIndex(gfxAddress));
+    auto *pte = static_cast<PTE *>(pde->getChild(pde->getIndex(gfxAddress)));
     ASSERT_NE(nullptr, pte);
-    ASSERT_EQ(nullptr, pte->getChild(pte->getIndex(gfxAddress)));
+    ASSERT_EQ(nullptr, pte->getLeaf(pte->getIndex(gfxAddress)));
 
     uint8_t buf[pageSize4K] = {};
     stream.AubStream::readMemory(&ppgtt, gfxAddress, buf, sizeof(buf), MEMORY_BANK_SYSTEM, pageSize4K);
 
-    EXPECT_EQ(nullptr, pte->getChild(pte->getIndex(gfxAddress)));
+    EXPECT_EQ(nullptr, pte->getLeaf(pte->getIndex(gfxAddress)));
 }
 
 TEST_F(ExpectWalkReleaseTest, givenMissing2MbPageWhenReadMemoryThenNoPageCreated) {
@@ -33,6 +33,8 @@ struct PageTableWalkerFixture : public ::testing::Test {
         for (const auto &levelNodes : walker.pendingNodes)
             for (auto *node : levelNodes)
                 node->setPendingWrite(false);
+        for (auto *leaf : walker.pendingLeaves)
+            leaf->setPendingWrite(false);
     }
 
     std::unique_ptr<PhysicalAddressAllocatorSimple> allocator;
@@ -61,6 +63,58 @@ TEST_F(PageTableWalkerTest, givenReserveModeAndPPGTTWhenWalkingMemoryForLocalMem
     EXPECT_EQ(2u, pageWalker.entries.size());
 }
 
+TEST(PooledPageTableWalker, givenReleasedWalkerWhenBorrowedAgainThenItIsEmptyAndKeepsItsBuffers) {
+    PageTableWalker *released = nullptr;
+    size_t capacity = 0;
+    {
+        PooledPageTableWalker walker;
+        walker->entries.resize(16);
+        walker->pageWalkEntries[PageTableLevel::Pte].resize(16);
+        released = &*walker;
+        capacity = walker->entries.capacity();
+    }
+
+    PooledPageTableWalker walker;
+    EXPECT_EQ(released, &*walker);
+    EXPECT_TRUE(walker->entries.empty());
+    EXPECT_TRUE(walker->pageWalkEntries[PageTableLevel::Pte].empty());
+    EXPECT_EQ(capacity, walker->entries.capacity());
+}
+
+TEST(PooledPageTableWalker, givenBorrowedWalkerWhenAnotherIsBorrowedThenTheyAreDifferent) {
+    PooledPageTableWalker outer;
+    PooledPageTableWalker inner;
+    EXPECT_NE(&*outer, &*inner);
+}
+
+TEST(PooledPageTableWalker, givenWalkerLargerThanPoolLimitWhenReleasedThenItsBuffersAreNotKept) {
+    {
+        PooledPageTableWalker walker;
+        walker->entries.resize(PooledPageTableWalker::maxPooledEntries + 1);
+    }
+
+    PooledPageTableWalker walker;
+    EXPECT_LE(walker->entries.capacity(), PooledPageTableWalker::maxPooledEntries);
+}
+
+TEST_F(PageTableWalkerTest, givenTablesLeftPendingByDiscardedWalkWhenWalkedAgainThenEachPendingTableIsEmittedOncePerWalk) {
+    const size_t size = 2 * Page2MB::pageSize2MB;
+
+    PageTableWalker discardedWalker;
+    discardedWalker.walkMemory(ppgtt.get(), {0, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr);
+
+    for (int walk = 0; walk < 2; walk++) {
+        PageTableWalker pageWalker;
+        pageWalker.walkMemory(ppgtt.get(), {0, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr);
+
+        EXPECT_EQ(1u, pageWalker.pendingNodes[PageTableLevel::Pml4].size());
+        EXPECT_EQ(1u, pageWalker.pendingNodes[PageTableLevel::Pdp].size());
+        EXPECT_EQ(2u, pageWalker.pendingNodes[PageTableLevel::Pde].size());
+        EXPECT_EQ(2u, pageWalker.pageWalkEntries[PageTableLevel::Pde].size());
+        EXPECT_EQ(size / 4096, pageWalker.pendingLeaves.size());
+    }
+}
+
 TEST_F(PageTableWalkerTest, givenReserveModeAndPPGTTWhenWalkingMemoryForSystem64KBMemoryThenPageTableWalkerHas64KBPagesAndCorrectPageWalkEntriesAndPageEntriesStored) {
     const uint64_t gfxAddress = ppgtt->getNumAddressBits() == 48
                                     ? (1ull << 39) - sizeof(uint32_t)
@@ -121,6 +175,30 @@ TEST_F(PageTableWalkerTest, givenReserveModeAndGGTTWhenWalkingMemoryForLocalMemo
     EXPECT_EQ(1u, pageWalker.entries.size());
 }
 
+TEST_F(PageTableWalkerTest, givenReserveModeAndGGTTWhenWalkingMemoryFor64KBPageTwiceThenSixteenConsecutiveEntriesAreWrittenOnce) {
+    const uint64_t gfxAddress = 0x20000;
+
+    PageTableWalker pageWalker;
+    pageWalker.walkMemory(ggtt.get(), gfxAddress, 65536, defaultMemoryBank, 65536, PageTableWalker::WalkMode::Reserve, nullptr);
+
+    auto &ggttEntries = pageWalker.pageWalkEntries[0];
+    ASSERT_EQ(16u, ggttEntries.size());
+    const auto index = ggtt->getIndex(gfxAddress);
+    const auto physicalAddress = ggtt->getEntry(index) & GGTT::physicalAddressMask;
+    for (auto i = 0u; i < 16u; i++) {
+        EXPECT_EQ(ggtt->getEntryOffset() + sizeof(uint64_t) * (index + i), ggttEntries[i].physicalAddress);
+        EXPECT_EQ(ggtt->getEntry(index + i), ggttEntries[i].tableEntry);
+        EXPECT_EQ(physicalAddress + i * 4096, ggttEntries[i].tableEntry & GGTT::physicalAddressMask);
+    }
+    EXPECT_EQ(0u, ggtt->getEntry(index + 16));
+
+    PageTableWalker rewalker;
+    rewalker.walkMemory(ggtt.get(), gfxAddress + 0x5000, 0x1000, defaultMemoryBank, 65536, PageTableWalker::WalkMode::Reserve, nullptr);
+    EXPECT_EQ(0u, rewalker.pageWalkEntries[0].size());
+    ASSERT_EQ(1u, rewalker.entries.size());
+    EXPECT_EQ(physicalAddress + 0x5000, rewalker.entries[0].physicalAddress);
+}
+
 // Tests for PreReserved Memory
 
 TEST_F(PageTableWalkerTest, givenReserveModeAndPPGTTWhenWalkingMemoryForLocalMemoryThenPageTableWalkerHasNo64KBPagesAndCorrectPageWalkEntriesAndPageEntriesStoredWithPreReserved) {
@@ -284,11 +362,11 @@ TEST_F(PageTableWalkerTest, givenReserveModeAndPPGTTWhenWalkingMemoryWithNewPhys
     ASSERT_NE(nullptr, pde);
 
     const auto pdeIndex = pde->getIndex(gfxAddress);
-    auto pte = pde->getChild(pdeIndex);
+    auto pte = static_cast<PTE *>(pde->getChild(pdeIndex));
     ASSERT_NE(nullptr, pte);
 
     const auto pteIndex = pte->getIndex(gfxAddress);
-    auto page = pte->getChild(pteIndex);
+    auto page = pte->getLeaf(pteIndex);
     ASSERT_NE(nullptr, page);
     EXPECT_EQ(physicalAddress, page->getPhysicalAddress());
     EXPECT_EQ(MEMORY_BANK_0, page->getMemoryBank());
@@ -305,7 +383,7 @@ TEST_F(PageTableWalkerTest, givenReserveModeAndPPGTTWhenWalkingMemoryWithNewPhys
 
     EXPECT_EQ(physicalAddress2 + (gfxAddress & (65536u - 1)), pageWalker2.entries[0].physicalAddress);
 
-    auto newPage = pte->getChild(pteIndex);
+    auto newPage = pte->getLeaf(pteIndex);
     ASSERT_NE(nullptr, newPage);
     EXPECT_TRUE(newPage->isLocalMemory());
     EXPECT_EQ(physicalAddress2, newPage->getPhysicalAddress());
@@ -817,6 +895,44 @@ TEST_F(PageTableWalkerTest, givenReserveModeAndPPGTTWithPreReservedPhysicalAddre
     EXPECT_EQ(physicalAddress + 2 * Page2MB::pageSize2MB, page3->getPhysicalAddress());
 }
 
+TEST_F(PageTableWalkerTest, givenReserveModeAndPPGTTWhenWalkingMemorySpanningSeveralPTEsThenInteriorEntriesAreEmittedOncePerTable) {
+    // Starts 8KB before a PDE boundary and spans two more full PTEs
+    const uint64_t gfxAddress = (1ull << 30) - 2 * 4096;
+    const size_t size = 2 * 4096 + 2 * Page2MB::pageSize2MB;
+
+    PageTableWalker pageWalker;
+    pageWalker.walkMemory(ppgtt.get(), {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr);
+
+    EXPECT_EQ(size / 4096, pageWalker.entries.size());
+    EXPECT_EQ(size / 4096, pageWalker.pageWalkEntries[PageTableLevel::Pte].size());
+    EXPECT_EQ(size / 4096, pageWalker.pendingLeaves.size());
+    EXPECT_EQ(3u, pageWalker.pageWalkEntries[PageTableLevel::Pde].size());
+    EXPECT_EQ(2u, pageWalker.pageWalkEntries[PageTableLevel::Pdp].size());
+    EXPECT_EQ(1u, pageWalker.pageWalkEntries[PageTableLevel::Pml4].size());
+
+    for (size_t i = 0; i < pageWalker.entries.size(); i++) {
+        auto pdp = ppgtt->getChild(ppgtt->getIndex(gfxAddress + i * 4096));
+        auto pde = pdp->getChild(pdp->getIndex(gfxAddress + i * 4096));
+        auto pte = static_cast<PTE *>(pde->getChild(pde->getIndex(gfxAddress + i * 4096)));
+        auto leaf = pte->getLeaf(pte->getIndex(gfxAddress + i * 4096));
+        ASSERT_NE(nullptr, leaf);
+        EXPECT_EQ(leaf->getPhysicalAddress(), pageWalker.entries[i].physicalAddress);
+        EXPECT_EQ(4096u, pageWalker.entries[i].size);
+    }
+    simulateWritePageWalkEntries(pageWalker);
+
+    PageTableWalker pageWalker2;
+    pageWalker2.walkMemory(ppgtt.get(), {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr);
+
+    EXPECT_EQ(size / 4096, pageWalker2.entries.size());
+    for (int level = PageTableLevel::Pte; level <= PageTableLevel::Pml4; level++) {
+        EXPECT_EQ(0u, pageWalker2.pageWalkEntries[level].size());
+    }
+    for (size_t i = 0; i < pageWalker.entries.size(); i++) {
+        EXPECT_EQ(pageWalker.entries[i].physicalAddress, pageWalker2.entries[i].physicalAddress);
+    }
+}
+
 using PageTableWalkerTestPml5Ps64 = PageTableWalkerFixture<PML5, 1>;
 
 TEST_F(PageTableWalkerTestPml5Ps64, givenPartialGroupWhenCompletedWithDifferentPermissionBitsThenPS64BitNotSet) {
@@ -1162,7 +1278,7 @@ TEST_F(PageTableWalkerTestPml5Ps64, givenPs64GroupPendingFromPriorWalkWhenSubseq
     for (const auto &entry : pteEntries) {
         EXPECT_TRUE(entry.tableEntry & ps64Mask);
     }
-    EXPECT_EQ(16u, writeWalker.pendingNodes[PageTableLevel::Pte].size());
+    EXPECT_EQ(16u, writeWalker.pendingLeaves.size());
 }
 
 TEST_F(PageTableWalkerTestPml5Ps64, givenPartialPs64GroupCommittedAt4KBWhenCompletedByReserveWalkThenSubsequentWalkEmitsAllGroupEntriesAsPs64) {
@@ -1224,5 +1340,112 @@ TEST_F(PageTableWalkerTestPml5Ps64, givenCommittedPs64GroupWhenDowngradedByDisca
                            PageTableWalker::WalkMode::Reserve, nullptr);
 
     EXPECT_EQ(16u, writeWalker.pageWalkEntries[PageTableLevel::Pte].size());
-    EXPECT_EQ(16u, writeWalker.pendingNodes[PageTableLevel::Pte].size());
+    EXPECT_EQ(16u, writeWalker.pendingLeaves.size());
+}
+
+namespace {
+void expectSameWalkResults(const PageTableWalker &expected, const PageTableWalker &actual) {
+    ASSERT_EQ(expected.entries.size(), actual.entries.size());
+    for (size_t i = 0; i < expected.entries.size(); i++) {
+        EXPECT_EQ(expected.entries[i].physicalAddress, actual.entries[i].physicalAddress);
+        EXPECT_EQ(expected.entries[i].size, actual.entries[i].size);
+        EXPECT_EQ(expected.entries[i].isLocalMemory, actual.entries[i].isLocalMemory);
+        EXPECT_EQ(expected.entries[i].memoryBank, actual.entries[i].memoryBank);
+    }
+    for (int level = PageTableLevel::Pte; level <= PageTableLevel::Pml5; level++) {
+        ASSERT_EQ(expected.pageWalkEntries[level].size(), actual.pageWalkEntries[level].size());
+        for (size_t i = 0; i < expected.pageWalkEntries[level].size(); i++) {
+            EXPECT_EQ(expected.pageWalkEntries[level][i].physicalAddress, actual.pageWalkEntries[level][i].physicalAddress);
+            EXPECT_EQ(expected.pageWalkEntries[level][i].tableEntry, actual.pageWalkEntries[level][i].tableEntry);
+        }
+    }
+    EXPECT_EQ(expected.pendingLeaves, actual.pendingLeaves);
+    EXPECT_EQ(expected.pages64KB, actual.pages64KB);
+}
+
+template <typename PPGTTType>
+void expectParallelWalkOfMappedMemoryMatchesSerialWalk(PPGTTType &ppgtt, size_t pageSize, PageTableWalker::WalkMode mode) {
+    const uint64_t gfxAddress = (1ull << 32) - 3 * pageSize + 4;
+    const size_t size = PageTableWalker::parallelWalkMinSize + pageSize;
+    const AllocationParams allocationParams = {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, pageSize};
+
+    globalSettings->PageTableWalkThreads.set(1);
+    {
+        PageTableWalker mappingWalker;
+        mappingWalker.walkMemory(&ppgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr);
+        for (const auto &levelNodes : mappingWalker.pendingNodes)
+            for (auto *node : levelNodes)
+                node->setPendingWrite(false);
+        // Leave some leaves in different PTEs pending
+        for (size_t i = 0; i < mappingWalker.pendingLeaves.size(); i++) {
+            mappingWalker.pendingLeaves[i]->setPendingWrite(i % 1000 == 0);
+        }
+    }
+
+    PageTableWalker serialWalker;
+    serialWalker.walkMemory(&ppgtt, allocationParams, mode, nullptr);
+
+    globalSettings->PageTableWalkThreads.set(4);
+    PageTableWalker parallelWalker;
+    parallelWalker.walkMemory(&ppgtt, allocationParams, mode, nullptr);
+
+    EXPECT_NE(0u, serialWalker.pageWalkEntries[PageTableLevel::Pte].size());
+    expectSameWalkResults(serialWalker, parallelWalker);
+}
+} // namespace
+
+TEST_F(PageTableWalkerTest, givenMappedMemoryWhenWalkingLargeRangeWithSeveralThreadsThenResultsMatchSerialWalk) {
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+
+    expectParallelWalkOfMappedMemoryMatchesSerialWalk(*ppgtt, 4096, PageTableWalker::WalkMode::Reserve);
+}
+
+TEST_F(PageTableWalkerTest, givenMappedMemoryWhenExpectWalkingLargeRangeOf64KBPagesWithSeveralThreadsThenResultsMatchSerialWalk) {
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+
+    expectParallelWalkOfMappedMemoryMatchesSerialWalk(*ppgtt, 65536, PageTableWalker::WalkMode::Expect);
+}
+
+using PageTableWalkerTestPml5 = PageTableWalkerFixture<PML5>;
+
+TEST_F(PageTableWalkerTestPml5, givenPs64EnabledAndMappedMemoryWhenWalkingLargeRangeWithSeveralThreadsThenResultsMatchSerialWalk) {
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+    globalSettings->EnablePs64.set(true);
+
+    expectParallelWalkOfMappedMemoryMatchesSerialWalk(*ppgtt, 4096, PageTableWalker::WalkMode::Reserve);
+}
+
+TEST_F(PageTableWalkerTest, givenUnmappedMemoryWhenWalkingLargeRangeWithSeveralThreadsThenPageTablesAreBuiltAsInSerialWalk) {
+    auto settings = std::make_unique<Settings>();
+    VariableBackup<Settings *> backup(&globalSettings);
+    globalSettings = settings.get();
+
+    const AllocationParams allocationParams = {(1ull << 32) + 4096, nullptr, PageTableWalker::parallelWalkMinSize, MEMORY_BANK_SYSTEM, 0, 4096};
+
+    PhysicalAddressAllocatorSimple serialAllocator(0, aub_stream::GB, true);
+    PML4 serialPpgtt(*gpu, &serialAllocator, defaultMemoryBank);
+    globalSettings->PageTableWalkThreads.set(1);
+    PageTableWalker serialWalker;
+    serialWalker.walkMemory(&serialPpgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr);
+
+    PhysicalAddressAllocatorSimple parallelAllocator(0, aub_stream::GB, true);
+    PML4 parallelPpgtt(*gpu, &parallelAllocator, defaultMemoryBank);
+    globalSettings->PageTableWalkThreads.set(4);
+    PageTableWalker parallelWalker;
+    parallelWalker.walkMemory(&parallelPpgtt, allocationParams, PageTableWalker::WalkMode::Reserve, nullptr);
+
+    EXPECT_EQ(allocationParams.size / 4096, parallelWalker.pendingLeaves.size());
+    ASSERT_EQ(serialWalker.entries.size(), parallelWalker.entries.size());
+    for (size_t i = 0; i < serialWalker.entries.size(); i++) {
+        EXPECT_EQ(serialWalker.entries[i].physicalAddress, parallelWalker.entries[i].physicalAddress);
+    }
+    for (int level = PageTableLevel::Pte; level <= PageTableLevel::Pml4; level++) {
+        EXPECT_EQ(serialWalker.pageWalkEntries[level].size(), parallelWalker.pageWalkEntries[level].size());
+    }
 }
@@ -10,6 +10,10 @@
 #include "aub_mem_dump/physical_address_allocator.h"
 #include "mock_physical_address_allocator.h"
 
+#include <cstring>
+#include <set>
+#include <thread>
+
 using namespace aub_stream;
 
 TEST(PhysicalAddressAllocator, whenDefaultCtorIsUsedThenNumberOfCreatedAllocatorsIsZero) {
@@ -95,21 +99,99 @@ TEST(PhysicalAddressAllocator, givenPhysicalAllocatorWithLocalMemorySupportAndSp
     EXPECT_EQ(2 * allocatorSize + reservedPhysicalMemory, physicalMemory3);
 }
 
-TEST(PhysicalAddressAllocator, givenHeapBasedAllocatorWhenReservingMemoryThenAllocatedMemoryIsStoredForRelease) {
+TEST(PhysicalAddressAllocator, givenHeapBasedAllocatorWhenReservingMemoryThenBlocksAreCarvedFromOneChunkAndTracked) {
     MockPhysicalAddressAllocatorHeap allocator;
 
     auto p1 = allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 4096, 4096);
-    EXPECT_EQ(allocator.storage.size(), 1);
-    auto i = allocator.storage.begin();
-    EXPECT_EQ(p1, reinterpret_cast<uint64_t>(i->get()));
     auto p2 = allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_1, 1024, 1024);
-    EXPECT_EQ(allocator.storage.size(), 2);
-    i++;
-    EXPECT_EQ(p2, reinterpret_cast<uint64_t>(i->get()));
-    auto p3 = allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_2, 512, 512);
-    EXPECT_EQ(allocator.storage.size(), 3);
-    i++;
-    EXPECT_EQ(p3, reinterpret_cast<uint64_t>(i->get()));
+    auto p3 = allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_2, 0x10000, 0x10000);
+
+    EXPECT_EQ(1u, allocator.chunks.size());
+    EXPECT_EQ(3u, allocator.liveBlocks.size());
+    EXPECT_EQ(0u, p1 % 0x1000);
+    EXPECT_EQ(0u, p2 % 0x1000);
+    EXPECT_EQ(0u, p3 % 0x10000);
+    EXPECT_NE(p1, p2);
+
+    const auto chunkBase = reinterpret_cast<uint64_t>(allocator.chunks[0].base);
+    for (auto p : {p1, p2, p3}) {
+        EXPECT_LE(chunkBase, p);
+        EXPECT_GE(chunkBase + PhysicalAddressAllocatorHeap::chunkSize, p + 0x1000);
+    }
+
+    auto footprint = allocator.getFootprint();
+    EXPECT_EQ(PhysicalAddressAllocatorHeap::chunkSize, footprint.mappedBytes);
+    EXPECT_EQ(0x12000u, footprint.liveBytes);
+}
+
+TEST(PhysicalAddressAllocator, givenHeapBasedAllocatorWhenBlockIsFreedThenItIsReusedForTheSameSizeClass) {
+    MockPhysicalAddressAllocatorHeap allocator;
+
+    auto p1 = allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x3000, 0x1000);
+    auto cachedBytes = allocator.getFootprint().cachedBytes;
+    allocator.freePhysicalMemory(MemoryBank::MEMORY_BANK_0, p1);
+
+    EXPECT_EQ(0u, allocator.liveBlocks.size());
+    EXPECT_EQ(0u, allocator.getFootprint().liveBytes);
+    EXPECT_EQ(cachedBytes + 0x4000, allocator.getFootprint().cachedBytes);
+
+    EXPECT_EQ(p1, allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x4000, 0x4000));
+    EXPECT_EQ(cachedBytes, allocator.getFootprint().cachedBytes);
+    EXPECT_EQ(1u, allocator.chunks.size());
+
+    // Unknown addresses are ignored
+    allocator.freePhysicalMemory(MemoryBank::MEMORY_BANK_0, p1 + 0x1000);
+    EXPECT_EQ(1u, allocator.liveBlocks.size());
+}
+
+TEST(PhysicalAddressAllocator, givenHeapBasedAllocatorWithOnlyLargerBlockCachedWhenSmallBlockIsReservedThenLargerBlockIsSplit) {
+    MockPhysicalAddressAllocatorHeap allocator;
+
+    auto p1 = allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, PhysicalAddressAllocatorHeap::maxBlockSize, PhysicalAddressAllocatorHeap::maxBlockSize);
+    for (auto &freeList : allocator.freeBlocks) {
+        freeList.clear();
+    }
+    allocator.freePhysicalMemory(MemoryBank::MEMORY_BANK_0, p1);
+
+    EXPECT_EQ(p1, allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x1000, 0x1000));
+    for (uint32_t sizeClass = 0; sizeClass < PhysicalAddressAllocatorHeap::sizeClassCount - 1; sizeClass++) {
+        ASSERT_EQ(1u, allocator.freeBlocks[sizeClass].size());
+        EXPECT_EQ(p1 + (0x1000u << sizeClass), reinterpret_cast<uint64_t>(allocator.freeBlocks[sizeClass][0]));
+    }
+    EXPECT_TRUE(allocator.freeBlocks[PhysicalAddressAllocatorHeap::sizeClassCount - 1].empty());
+}
+
+TEST(PhysicalAddressAllocator, givenHeapBasedAllocatorWhenBlockAboveLargestSizeClassIsReservedThenItIsMappedOnItsOwnAndUnmappedOnFree) {
+    MockPhysicalAddressAllocatorHeap allocator;
+
+    auto p = allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x300000, 0x10000);
+    EXPECT_EQ(0u, p % 0x10000);
+    EXPECT_EQ(0u, allocator.chunks.size());
+    EXPECT_EQ(1u, allocator.largeBlocks.size());
+    memset(reinterpret_cast<void *>(p), 0xFF, 0x300000);
+    EXPECT_EQ(0x310000u, allocator.getFootprint().mappedBytes);
+
+    allocator.freePhysicalMemory(MemoryBank::MEMORY_BANK_0, p);
+    EXPECT_EQ(0u, allocator.largeBlocks.size());
+    EXPECT_EQ(0u, allocator.getFootprint().mappedBytes);
+    EXPECT_EQ(0u, allocator.getFootprint().liveBytes);
+}
+
+TEST(PhysicalAddressAllocator, givenHeapBasedAllocatorWhenChunkIsExhaustedThenItsTailIsKeptInFreeListsAndNewChunkIsMapped) {
+    MockPhysicalAddressAllocatorHeap allocator;
+    constexpr size_t blocksPerChunk = PhysicalAddressAllocatorHeap::chunkSize / PhysicalAddressAllocatorHeap::maxBlockSize;
+
+    allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x1000, 0x1000);
+    for (size_t i = 0; i < blocksPerChunk; i++) {
+        allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, PhysicalAddressAllocatorHeap::maxBlockSize, PhysicalAddressAllocatorHeap::maxBlockSize);
+    }
+    EXPECT_EQ(2u, allocator.chunks.size());
+
+    auto footprint = allocator.getFootprint();
+    EXPECT_EQ(2 * PhysicalAddressAllocatorHeap::chunkSize, footprint.mappedBytes);
+    EXPECT_EQ(blocksPerChunk * PhysicalAddressAllocatorHeap::maxBlockSize + 0x1000, footprint.liveBytes);
+    EXPECT_LE(footprint.liveBytes + footprint.cachedBytes, footprint.mappedBytes);
+    EXPECT_LE(PhysicalAddressAllocatorHeap::maxBlockSize - 0x1000, footprint.cachedBytes);
 }
 
 TEST(PhysicalAddressAllocator, whenPhysicalAllocatorIsCreatedWithInHeapParameterThenPhysicalAddressAllocatorHeapIsCreated) {
@@ -270,7 +352,8 @@ TEST(PhysicalAddressAllocator, givenSimpleAllocatorWhenMemoryIsFreedThenReuseMem
     allocator.alignedFree(pointer2);
     allocator.alignedFree(pointer1);
     EXPECT_EQ(allocator.usedAllocationsMap.size(), 0);
-    EXPECT_EQ(allocator.freeAllocationsMap.size(), 2);
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 0);
+    EXPECT_EQ(pointer1, allocator.nextAddress);
 
     auto pointer3 = allocator.alignedAlloc(sizeToAllocate, alignment);
     auto pointer4 = allocator.alignedAlloc(sizeToAllocate, alignment);
@@ -294,17 +377,139 @@ TEST(PhysicalAddressAllocator, givenSimpleAllocatorWhenDifferentSizeMemoryIsFree
     EXPECT_EQ(allocator.freeAllocationsMap.size(), 0);
 
     allocator.alignedFree(pointer1);
+    EXPECT_EQ(allocator.usedAllocationsMap.size(), 1);
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 1);
     allocator.alignedFree(pointer2);
     EXPECT_EQ(allocator.usedAllocationsMap.size(), 0);
-    EXPECT_EQ(allocator.freeAllocationsMap.size(), 2);
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 0);
 
     auto pointer3 = allocator.alignedAlloc(sizeToAllocate3, alignment);
     EXPECT_EQ(allocator.usedAllocationsMap.size(), 1);
-    EXPECT_EQ(allocator.freeAllocationsMap.size(), 2);
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 0);
     auto pointer4 = allocator.alignedAlloc(sizeToAllocate2, alignment);
     EXPECT_EQ(allocator.usedAllocationsMap.size(), 2);
-    EXPECT_EQ(allocator.freeAllocationsMap.size(), 1);
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 0);
     EXPECT_NE(pointer3, pointer4);
     EXPECT_EQ(pointer2, pointer4);
     EXPECT_NE(pointer1, pointer4);
 }
+
+TEST(PhysicalAddressAllocator, givenFreedNeighboursWhenLargerBlockIsAllocatedThenTheyAreMergedAndReused) {
+    MockSimpleAllocator<uint64_t> allocator{0x10000};
+
+    auto pointer1 = allocator.alignedAlloc(0x1000, 0x1000);
+    auto pointer2 = allocator.alignedAlloc(0x1000, 0x1000);
+    auto pointer3 = allocator.alignedAlloc(0x1000, 0x1000);
+    allocator.alignedAlloc(0x1000, 0x1000);
+
+    allocator.alignedFree(pointer1);
+    allocator.alignedFree(pointer3);
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 2);
+    allocator.alignedFree(pointer2);
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 1);
+
+    EXPECT_EQ(pointer1, allocator.alignedAlloc(0x3000, 0x1000));
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 0);
+}
+
+TEST(PhysicalAddressAllocator, givenFreeBlockWhenAlignedBlockIsAllocatedFromItThenRemaindersStayFree) {
+    MockSimpleAllocator<uint64_t> allocator{0x11000};
+
+    std::vector<uint64_t> pages;
+    for (int i = 0; i < 32; i++) {
+        pages.push_back(allocator.alignedAlloc(0x1000, 0x1000));
+    }
+    allocator.alignedAlloc(0x1000, 0x1000);
+    for (auto page : pages) {
+        allocator.alignedFree(page);
+    }
+    EXPECT_EQ(allocator.freeAllocationsMap.size(), 1);
+
+    EXPECT_EQ(0x20000u, allocator.alignedAlloc(0x10000, 0x10000));
+    ASSERT_EQ(allocator.freeAllocationsMap.size(), 2);
+    EXPECT_EQ(0xf000u, allocator.freeAllocationsMap.at(0x11000));
+    EXPECT_EQ(0x1000u, allocator.freeAllocationsMap.at(0x30000));
+
+    // Best fit takes the smaller remainder
+    EXPECT_EQ(0x30000u, allocator.alignedAlloc(0x1000, 0x1000));
+}
+
+TEST(PhysicalAddressAllocator, givenAlignmentPaddingBeforeNextAddressWhenSmallerBlockIsAllocatedThenPaddingIsReused) {
+    MockSimpleAllocator<uint32_t> allocator{0x1000};
+
+    EXPECT_EQ(0x10000u, allocator.alignedAlloc(0x10000, 0x10000));
+    EXPECT_EQ(0x1000u, allocator.alignedAlloc(0x1000, 0x1000));
+    EXPECT_EQ(0x20000u, allocator.nextAddress);
+}
+
+TEST(PhysicalAddressAllocator, givenSimpleAllocatorHeldByAnotherThreadWhenTryingToAllocateThenItReturnsWithoutAllocating) {
+    MockSimpleAllocator<uint64_t> allocator{0x10000};
+    uint64_t address = 0;
+
+    std::unique_lock<std::mutex> lock(allocator.mutex);
+    std::thread([&]() {
+        EXPECT_FALSE(allocator.tryAlignedAlloc(0x1000, 0x1000, address));
+    }).join();
+    lock.unlock();
+
+    EXPECT_EQ(0x10000u, allocator.nextAddress);
+    EXPECT_TRUE(allocator.tryAlignedAlloc(0x1000, 0x1000, address));
+    EXPECT_EQ(0x10000u, address);
+}
+
+TEST(PhysicalAddressAllocator, givenSimpleAllocatorWhenBatchIsAllocatedThenBlocksAreAlignedAndConsecutive) {
+    MockSimpleAllocator<uint64_t> allocator{0x11000};
+    uint64_t addresses[3] = {};
+
+    allocator.alignedAllocBatch(0x10000, 0x10000, addresses, 3);
+
+    EXPECT_EQ(0x20000u, addresses[0]);
+    EXPECT_EQ(0x30000u, addresses[1]);
+    EXPECT_EQ(0x40000u, addresses[2]);
+    EXPECT_EQ(3u, allocator.usedAllocationsMap.size());
+}
+
+TEST(PhysicalAddressAllocator, givenThreadThatSawContentionWhenChunkIsReservedThenMagazineIsRefilledInBatch) {
+    MockPhysicalAddressAllocatorSimple allocator(1, 1 * GB, false);
+    auto &magazine = allocator.getThreadMagazines()[1][0];
+    magazine.refillCount = PhysicalAddressAllocatorSimple::minMagazineRefill;
+
+    EXPECT_EQ(0x1000u, allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x1000, 0x1000));
+    EXPECT_EQ(2 * PhysicalAddressAllocatorSimple::minMagazineRefill - 1, magazine.chunks.size());
+    EXPECT_EQ(0x2000u, allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x1000, 0x1000));
+
+    // Sizes without a magazine and other banks still come straight from their allocator
+    EXPECT_EQ(0x9000u, allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_0, 0x3000, 0x1000));
+    EXPECT_EQ(reservedGGTTSpace, allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_SYSTEM, 0x1000, 0x1000));
+}
+
+TEST(PhysicalAddressAllocator, givenSeveralThreadsWhenReservingChunksConcurrentlyThenEachChunkIsHandedOutOnce) {
+    constexpr size_t threadCount = 4;
+    constexpr size_t chunksPerThread = 1000;
+    MockPhysicalAddressAllocatorSimple allocator(2, 1 * GB, false);
+
+    std::vector<std::vector<uint64_t>> reserved(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < chunksPerThread; i++) {
+                const size_t chunkSize = i % 10 == 0 ? 0x10000 : 0x1000;
+                reserved[t].push_back(allocator.reservePhysicalMemory(MemoryBank::MEMORY_BANK_1, chunkSize, chunkSize));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::set<uint64_t> unique;
+    for (size_t t = 0; t < threadCount; t++) {
+        for (size_t i = 0; i < chunksPerThread; i++) {
+            const uint64_t chunkSize = i % 10 == 0 ? 0x10000 : 0x1000;
+            EXPECT_EQ(0u, reserved[t][i] % chunkSize);
+            EXPECT_LE(1 * GB, reserved[t][i]);
+            unique.insert(reserved[t][i]);
+        }
+    }
+    EXPECT_EQ(threadCount * chunksPerThread, unique.size());
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "aub_mem_dump/poll_helper.h"
+
+using namespace aub_stream;
+
+TEST(PollHelper, givenConditionMetAfterFewChecksWhenPollingThenMatchedIsReturnedAndIterationsAreCounted) {
+    PollPolicy policy;
+    policy.spinCount = 2;
+    policy.yieldCount = 2;
+    policy.initialSleepMicroseconds = 1;
+    policy.maxSleepMicroseconds = 4;
+    PollStatistics statistics;
+
+    uint32_t checks = 0;
+    auto status = poll(policy, statistics, [&]() { return ++checks == 7 ? PollStatus::matched : PollStatus::pending; });
+
+    EXPECT_EQ(PollStatus::matched, status);
+    EXPECT_EQ(7u, checks);
+    EXPECT_EQ(1u, statistics.pollCount);
+    EXPECT_EQ(7u, statistics.iterationCount);
+    EXPECT_EQ(7u, statistics.maxIterations);
+    EXPECT_EQ(3u, statistics.sleepCount);
+    EXPECT_EQ(0u, statistics.timeoutCount);
+
+    checks = 5;
+    poll(policy, statistics, [&]() { return ++checks == 7 ? PollStatus::matched : PollStatus::pending; });
+    EXPECT_EQ(2u, statistics.pollCount);
+    EXPECT_EQ(9u, statistics.iterationCount);
+    EXPECT_EQ(7u, statistics.maxIterations);
+    EXPECT_EQ(3u, statistics.sleepCount);
+}
+
+TEST(PollHelper, givenFailingCheckWhenPollingThenFailedIsReturnedImmediately) {
+    PollStatistics statistics;
+    auto status = poll(PollPolicy{}, statistics, []() { return PollStatus::failed; });
+
+    EXPECT_EQ(PollStatus::failed, status);
+    EXPECT_EQ(1u, statistics.iterationCount);
+    EXPECT_EQ(0u, statistics.timeoutCount);
+}
+
+TEST(PollHelper, givenTimeoutWhenConditionIsNeverMetThenTimedOutIsReturned) {
+    PollPolicy policy;
+    policy.spinCount = 0;
+    policy.yieldCount = 0;
+    policy.maxSleepMicroseconds = 100;
+    policy.timeoutMilliseconds = 2;
+    PollStatistics statistics;
+
+    auto start = std::chrono::steady_clock::now();
+    auto status = poll(policy, statistics, []() { return PollStatus::pending; });
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(PollStatus::timedOut, status);
+    EXPECT_GE(elapsed, std::chrono::milliseconds(2));
+    EXPECT_EQ(1u, statistics.timeoutCount);
+    EXPECT_EQ(statistics.iterationCount - 1, statistics.sleepCount);
+}
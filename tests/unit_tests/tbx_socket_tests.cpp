@@ -46,3 +46,101 @@ TEST(TbxSocketsTest, givenTbxSocketInErrorStateWhenReadMMIOIsCalledThenReturnEar
 
     EXPECT_FALSE(tbxSocket.readMMIO(0, nullptr));
 }
+
+#include "aub_mem_dump/tbx_proto.h"
+#include <vector>
+
+namespace {
+struct TbxSocketsBatchingTest : public ::testing::Test {
+    void SetUp() override {
+        ON_CALL(tbxSocket, sendWriteData(_, _)).WillByDefault([this](const void *buffer, size_t sizeInBytes) {
+            sends.emplace_back(reinterpret_cast<const char *>(buffer), reinterpret_cast<const char *>(buffer) + sizeInBytes);
+            return true;
+        });
+    }
+
+    std::vector<char> allSentData() {
+        std::vector<char> data;
+        for (auto &send : sends) {
+            data.insert(data.end(), send.begin(), send.end());
+        }
+        return data;
+    }
+
+    ::testing::NiceMock<MockTbxSocketsImp> tbxSocket;
+    std::vector<std::vector<char>> sends;
+};
+} // namespace
+
+TEST_F(TbxSocketsBatchingTest, givenSendBufferWhenWritesAreIssuedThenTheyAreSentInOrderInSingleSendOnFlush) {
+    tbxSocket.sendBufferSize = 4096;
+
+    std::vector<uint32_t> payload(16, 0xCAFE);
+    EXPECT_TRUE(tbxSocket.writeMMIO(0x2000, 1));
+    EXPECT_TRUE(tbxSocket.writeGTT(0x8, 0x1234));
+    EXPECT_TRUE(tbxSocket.writeMemory(0x10000, payload.data(), payload.size() * sizeof(uint32_t), false));
+    EXPECT_TRUE(sends.empty());
+
+    EXPECT_TRUE(tbxSocket.flush());
+    ASSERT_EQ(1u, sends.size());
+    auto &sent = sends[0];
+
+    size_t offset = 0;
+    uint32_t expectedTypes[] = {HAS_MMIO_REQ_TYPE, HAS_GTT_REQ_TYPE, HAS_WRITE_DATA_REQ_TYPE};
+    for (uint32_t i = 0; i < 3; i++) {
+        ASSERT_LE(offset + sizeof(HAS_HDR), sent.size());
+        auto header = reinterpret_cast<const HAS_HDR *>(sent.data() + offset);
+        EXPECT_EQ(expectedTypes[i], header->msg_type);
+        EXPECT_EQ(i, header->trans_id);
+        offset += sizeof(HAS_HDR) + header->size;
+    }
+    ASSERT_EQ(offset + payload.size() * sizeof(uint32_t), sent.size());
+    EXPECT_EQ(0, memcmp(payload.data(), sent.data() + offset, payload.size() * sizeof(uint32_t)));
+
+    EXPECT_TRUE(tbxSocket.flush());
+    EXPECT_EQ(1u, sends.size());
+}
+
+TEST_F(TbxSocketsBatchingTest, givenPendingWritesWhenReadIsRequestedThenRequestIsSentWithPendingWritesBeforeResponseIsAwaited) {
+    tbxSocket.sendBufferSize = 4096;
+
+    EXPECT_TRUE(tbxSocket.writeMMIO(0x2000, 1));
+    EXPECT_CALL(tbxSocket, getResponseData(_, _)).WillOnce([this](void *buffer, size_t sizeInBytes) {
+        EXPECT_EQ(1u, sends.size());
+        return false;
+    });
+
+    uint32_t value = 0;
+    tbxSocket.TbxSocketsImp::readMMIO(0x2000, &value);
+
+    ASSERT_EQ(1u, sends.size());
+    auto mmioMessageSize = sizeof(HAS_HDR) + sizeof(HAS_MMIO_REQ);
+    ASSERT_EQ(2 * mmioMessageSize, sends[0].size());
+    EXPECT_EQ(0u, reinterpret_cast<const HAS_HDR *>(sends[0].data())->trans_id);
+    EXPECT_EQ(1u, reinterpret_cast<const HAS_HDR *>(sends[0].data() + mmioMessageSize)->trans_id);
+}
+
+TEST_F(TbxSocketsBatchingTest, givenWriteLargerThanSendBufferWhenIssuedThenItIsSentImmediatelyAfterPendingMessages) {
+    tbxSocket.sendBufferSize = 64;
+
+    EXPECT_TRUE(tbxSocket.writeMMIO(0x2000, 1));
+    EXPECT_TRUE(sends.empty());
+
+    std::vector<uint8_t> payload(1024, 0x5A);
+    EXPECT_TRUE(tbxSocket.writeMemory(0x10000, payload.data(), payload.size(), false));
+
+    ASSERT_EQ(2u, sends.size());
+    auto mmioMessageSize = sizeof(HAS_HDR) + sizeof(HAS_MMIO_REQ);
+    auto writeMessageSize = sizeof(HAS_HDR) + sizeof(HAS_WRITE_DATA_REQ);
+    auto sent = allSentData();
+    ASSERT_EQ(mmioMessageSize + writeMessageSize + payload.size(), sent.size());
+    EXPECT_EQ(HAS_MMIO_REQ_TYPE, reinterpret_cast<const HAS_HDR *>(sent.data())->msg_type);
+    EXPECT_EQ(HAS_WRITE_DATA_REQ_TYPE, reinterpret_cast<const HAS_HDR *>(sent.data() + mmioMessageSize)->msg_type);
+    EXPECT_EQ(0, memcmp(payload.data(), sent.data() + mmioMessageSize + writeMessageSize, payload.size()));
+}
+
+TEST_F(TbxSocketsBatchingTest, givenSendBufferDisabledWhenWriteIsIssuedThenItIsSentImmediately) {
+    EXPECT_TRUE(tbxSocket.writeMMIO(0x2000, 1));
+    ASSERT_EQ(1u, sends.size());
+    EXPECT_EQ(sizeof(HAS_HDR) + sizeof(HAS_MMIO_REQ), sends[0].size());
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "aub_mem_dump/memory_banks.h"
+#include "aub_mem_dump/page_table.h"
+#include "aub_mem_dump/page_table_walker.h"
+#include "aub_mem_dump/translation_cache.h"
+#include "mock_aub_stream.h"
+#include "test_defaults.h"
+#include "test.h"
+
+#include "gtest/gtest.h"
+
+using namespace aub_stream;
+
+namespace {
+
+struct TranslationCacheTest : public MockAubStreamFixture, public ::testing::Test {
+    void SetUp() override { MockAubStreamFixture::SetUp(); }
+    void TearDown() override { MockAubStreamFixture::TearDown(); }
+
+    std::vector<PageInfo> expectWalk(PageTable *ppgtt, uint64_t gfxAddress, size_t size) {
+        PageTableWalker walker;
+        walker.walkMemory(ppgtt, {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Expect, nullptr);
+        return walker.entries;
+    }
+
+    void expectSameEntries(const std::vector<PageInfo> &expected, const std::vector<PageInfo> &actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_EQ(expected[i].physicalAddress, actual[i].physicalAddress);
+            EXPECT_EQ(expected[i].size, actual[i].size);
+            EXPECT_EQ(expected[i].isLocalMemory, actual[i].isLocalMemory);
+            EXPECT_EQ(expected[i].memoryBank, actual[i].memoryBank);
+        }
+    }
+
+    PhysicalAddressAllocatorSimple allocator;
+};
+
+} // namespace
+
+TEST(TranslationCache, givenInsertedTranslationWhenLookedUpThenItIsReturnedForThatPageOnly) {
+    TranslationCache cache;
+    TranslationCache::Translation translation = {};
+    EXPECT_FALSE(cache.lookup(0x10000, translation));
+
+    cache.insert(0x10000, {0x200000, 65536, true});
+    ASSERT_TRUE(cache.lookup(0x10abc, translation));
+    EXPECT_EQ(0x200000u, translation.physicalAddress);
+    EXPECT_EQ(65536u, translation.pageSize);
+    EXPECT_TRUE(translation.isLocalMemory);
+
+    EXPECT_FALSE(cache.lookup(0x11000, translation));
+}
+
+TEST(TranslationCache, givenPageMappingToSameEntryWhenInsertedThenPreviousTranslationIsEvicted) {
+    TranslationCache cache;
+    const uint64_t conflictingAddress = 0x10000 + TranslationCache::entryCount * 4096;
+    cache.insert(0x10000, {0x200000, 4096, false});
+    cache.insert(conflictingAddress, {0x300000, 4096, false});
+
+    TranslationCache::Translation translation = {};
+    EXPECT_FALSE(cache.lookup(0x10000, translation));
+    ASSERT_TRUE(cache.lookup(conflictingAddress, translation));
+    EXPECT_EQ(0x300000u, translation.physicalAddress);
+}
+
+TEST(TranslationCache, givenInvalidatedRangeWhenLookedUpThenWholeEnclosing2MBPagesAreInvalidated) {
+    TranslationCache cache;
+    const uint64_t base = 0x40000000;
+    cache.insert(base + 0x1000, {0x1000, 4096, false});
+    cache.insert(base + TranslationCache::invalidationAlignment - 0x1000, {0x2000, 4096, false});
+    cache.insert(base + TranslationCache::invalidationAlignment, {0x3000, 4096, false});
+
+    cache.invalidate(base + 0x10000, 0x1000);
+
+    TranslationCache::Translation translation = {};
+    EXPECT_FALSE(cache.lookup(base + 0x1000, translation));
+    EXPECT_FALSE(cache.lookup(base + TranslationCache::invalidationAlignment - 0x1000, translation));
+    EXPECT_TRUE(cache.lookup(base + TranslationCache::invalidationAlignment, translation));
+}
+
+TEST_F(TranslationCacheTest, givenMappedRangeWhenExpectWalkIsRepeatedThenCachedEntriesMatchReservedEntries) {
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    const uint64_t gfxAddress = 0x100000000ull + 0x800;
+    const size_t size = 128 * 1024;
+
+    PageTableWalker reserveWalker;
+    reserveWalker.walkMemory(&ppgtt, {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr, 0x10000000ull);
+    EXPECT_EQ(size / 4096 + 1, reserveWalker.entries.size());
+
+    // First walk fills the cache from the page tables, the second one is served from it
+    expectSameEntries(reserveWalker.entries, expectWalk(&ppgtt, gfxAddress, size));
+    expectSameEntries(reserveWalker.entries, expectWalk(&ppgtt, gfxAddress, size));
+}
+
+TEST_F(TranslationCacheTest, givenCachedTranslationWhenRangeIsRemappedThenExpectWalkReturnsNewPhysicalAddress) {
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    const uint64_t gfxAddress = 0x100000000ull;
+    const size_t size = 16 * 1024;
+
+    PageTableWalker reserveWalker;
+    reserveWalker.walkMemory(&ppgtt, {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr, 0x10000000ull);
+    auto entries = expectWalk(&ppgtt, gfxAddress, size);
+    ASSERT_EQ(4u, entries.size());
+    EXPECT_EQ(0x10000000ull, entries[0].physicalAddress);
+
+    PageTableWalker remapWalker;
+    remapWalker.walkMemory(&ppgtt, {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr, 0x20000000ull);
+    entries = expectWalk(&ppgtt, gfxAddress, size);
+    ASSERT_EQ(4u, entries.size());
+    EXPECT_EQ(0x20000000ull, entries[0].physicalAddress);
+    EXPECT_EQ(0x20003000ull, entries[3].physicalAddress);
+}
+
+TEST_F(TranslationCacheTest, givenCachedTranslationWhenRangeIsFreedThenExpectWalkDoesNotUseCachedEntries) {
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_SYSTEM);
+    const uint64_t gfxAddress = 0x100000000ull;
+    const size_t size = 16 * 1024;
+
+    PageTableWalker reserveWalker;
+    reserveWalker.walkMemory(&ppgtt, {gfxAddress, nullptr, size, MEMORY_BANK_SYSTEM, 0, 4096}, PageTableWalker::WalkMode::Reserve, nullptr, 0x10000000ull);
+    EXPECT_EQ(4u, expectWalk(&ppgtt, gfxAddress, size).size());
+
+    stream.AubStream::freeMemory(&ppgtt, gfxAddress, size);
+
+    TranslationCache::Translation translation = {};
+    EXPECT_FALSE(ppgtt.getTranslationCache().lookup(gfxAddress, translation));
+}
+
+TEST_F(TranslationCacheTest, given2MBPageWhenExpectWalkIsDoneInsideItThenOneEntryWithPageOffsetIsReturned) {
+    TEST_REQUIRES(localMemorySupportedInTests);
+    TEST_REQUIRES(gpu->isMemorySupported(MEMORY_BANK_0, Page2MB::pageSize2MB));
+
+    PML4 ppgtt(*gpu, &allocator, MEMORY_BANK_0);
+    const uint64_t gfxAddress = 0x200000;
+    const size_t size = Page2MB::pageSize2MB;
+
+    PageTableWalker reserveWalker;
+    reserveWalker.walkMemory(&ppgtt, {gfxAddress, nullptr, size, MEMORY_BANK_0, 0, Page2MB::pageSize2MB}, PageTableWalker::WalkMode::Reserve, nullptr, 0x40000000ull);
+
+    for (int i = 0; i < 2; i++) {
+        PageTableWalker expectWalker;
+        expectWalker.walkMemory(&ppgtt, {gfxAddress + 0x5000, nullptr, 0x3000, MEMORY_BANK_0, 0, Page2MB::pageSize2MB}, PageTableWalker::WalkMode::Expect, nullptr);
+        ASSERT_EQ(1u, expectWalker.entries.size());
+        EXPECT_EQ(0x40005000ull, expectWalker.entries[0].physicalAddress);
+        EXPECT_EQ(0x3000u, expectWalker.entries[0].size);
+        EXPECT_TRUE(expectWalker.entries[0].isLocalMemory);
+    }
+}